@@ -82,7 +82,7 @@ FLAG(gc_pointers,       '9', 0,   "Garbage collector (pointers)"),
 FLAG(time,              ':', 0,   "Command list and allocator time summary"),
 UNUSED(';')
 UNUSED('<')
-UNUSED('=')
+FLAG(downscale_check,   '=', 0,   "Check the downscaler against its reference cores"),
 UNUSED('>')
 FLAG(validate_pointers, '?', 0,   "Validate pointers before/during/after garbage collection/save and restore"),
 FLAG(memfill_empty,     '@', 0,   "Fill empty storage with a distinctive bit pattern for debugging"),
@@ -38,6 +38,8 @@
 #include "gdevpccm.h"
 #include "gscdefs.h"
 #include "gxdownscale.h"
+#include "gxarith.h"
+#include "gpsync.h"
 
 /*
  * libpng versions 1.0.3 and later allow disabling access to the stdxxx
@@ -54,6 +56,7 @@
  */
 /*#define PNG_NO_STDIO*/
 #include "png_.h"
+#include "zlib.h"
 
 /* ------ The device descriptors ------ */
 
@@ -73,6 +76,8 @@ static dev_proc_fillpage(pngalpha_fillpage);
 static dev_proc_get_params(pngalpha_get_params);
 static dev_proc_put_params(pngalpha_put_params);
 static dev_proc_create_buf_device(pngalpha_create_buf_device);
+static dev_proc_get_params(png_get_params);
+static dev_proc_put_params(png_put_params);
 static dev_proc_get_params(png_get_params_downscale);
 static dev_proc_put_params(png_put_params_downscale);
 static dev_proc_get_params(png_get_params_downscale_mfs);
@@ -84,22 +89,39 @@ struct gx_device_png_s {
     gx_prn_device_common;
     int downscale_factor;
     int min_feature_size;
+    int compression_level;	/* zlib level (1-9), 0 = not specified */
+    int filter;			/* index in png_filter_names, 0 = adaptive */
+};
+
+/* The values of the PNGFilter parameter.  Apart from "adaptive", which */
+/* lets libpng choose the filter for each row, index - 1 is the filter type. */
+static const char *const png_filter_names[] = {
+    "adaptive", "none", "sub", "up", "average", "paeth"
+};
+static const int png_filter_masks[] = {
+    PNG_ALL_FILTERS, PNG_FILTER_NONE, PNG_FILTER_SUB, PNG_FILTER_UP,
+    PNG_FILTER_AVG, PNG_FILTER_PAETH
 };
 
 /* Monochrome. */
 
-const gx_device_png gs_pngmono_device =
-prn_device(prn_std_procs, "pngmono",
+static const gx_device_procs pngmono_procs =
+prn_params_procs(gdev_prn_open, gdev_prn_output_page, gdev_prn_close,
+                 png_get_params, png_put_params);
+const gx_device_png gs_pngmono_device = {
+  prn_device_std_body(gx_device_png, pngmono_procs, "pngmono",
            DEFAULT_WIDTH_10THS, DEFAULT_HEIGHT_10THS,
            X_DPI, Y_DPI,
            0, 0, 0, 0,		/* margins */
-           1, png_print_page);
+           1, png_print_page)
+};
 
 /* 4-bit planar (EGA/VGA-style) color. */
 
 static const gx_device_procs png16_procs =
-prn_color_procs(gdev_prn_open, gdev_prn_output_page, gdev_prn_close,
-                pc_4bit_map_rgb_color, pc_4bit_map_color_rgb);
+prn_color_params_procs(gdev_prn_open, gdev_prn_output_page, gdev_prn_close,
+                       pc_4bit_map_rgb_color, pc_4bit_map_color_rgb,
+                       png_get_params, png_put_params);
 const gx_device_png gs_png16_device = {
   prn_device_body(gx_device_png, png16_procs, "png16",
            DEFAULT_WIDTH_10THS, DEFAULT_HEIGHT_10THS,
@@ -112,8 +134,9 @@ const gx_device_png gs_png16_device = {
 /* (Uses a fixed palette of 3,3,2 bits.) */
 
 static const gx_device_procs png256_procs =
-prn_color_procs(gdev_prn_open, gdev_prn_output_page, gdev_prn_close,
-                pc_8bit_map_rgb_color, pc_8bit_map_color_rgb);
+prn_color_params_procs(gdev_prn_open, gdev_prn_output_page, gdev_prn_close,
+                       pc_8bit_map_rgb_color, pc_8bit_map_color_rgb,
+                       png_get_params, png_put_params);
 const gx_device_png gs_png256_device = {
   prn_device_body(gx_device_png, png256_procs, "png256",
            DEFAULT_WIDTH_10THS, DEFAULT_HEIGHT_10THS,
@@ -171,8 +194,9 @@ const gx_device_png gs_png16m_device =
 /* 48 bit color. */
 
 static const gx_device_procs png48_procs =
-prn_color_procs(gdev_prn_open, gdev_prn_output_page, gdev_prn_close,
-                gx_default_rgb_map_rgb_color, gx_default_rgb_map_color_rgb);
+prn_color_params_procs(gdev_prn_open, gdev_prn_output_page, gdev_prn_close,
+                       gx_default_rgb_map_rgb_color, gx_default_rgb_map_color_rgb,
+                       png_get_params, png_put_params);
 const gx_device_png gs_png48_device =
 {prn_device_body(gx_device_png, png48_procs, "png48",
                  DEFAULT_WIDTH_10THS, DEFAULT_HEIGHT_10THS,
@@ -195,6 +219,8 @@ struct gx_device_pngalpha_s {
     gx_prn_device_common;
     int downscale_factor;
     int min_feature_size;
+    int compression_level;
+    int filter;
     int background;
 };
 static const gx_device_procs pngalpha_procs =
@@ -295,11 +321,96 @@ const gx_device_pngalpha gs_pngalpha_device = {
         prn_device_body_rest_(png_print_page),
         1, /* downscale_factor */
         0, /* min_feature_size */
+        0, /* compression_level */
+        0, /* filter */
         0xffffff	/* white background */
 };
 
 /* ------ Private definitions ------ */
 
+/* Get and put the parameters that control the compression. */
+static int
+png_get_compression_params(gx_device_png *pdev, gs_param_list *plist)
+{
+    int code, ecode = 0;
+    gs_param_string fstr;
+
+    if ((code = param_write_int(plist, "PNGCompressionLevel", &pdev->compression_level)) < 0)
+        ecode = code;
+    param_string_from_string(fstr, png_filter_names[pdev->filter]);
+    if ((code = param_write_string(plist, "PNGFilter", &fstr)) < 0)
+        ecode = code;
+    return ecode;
+}
+
+static int
+png_read_compression_params(gs_param_list *plist, int *plevel, int *pfilter)
+{
+    int code, ecode = 0;
+    const char *param_name;
+    gs_param_string fstr;
+    int i;
+
+    switch (code = param_read_int(plist, (param_name = "PNGCompressionLevel"), plevel)) {
+        case 0:
+            if (*plevel >= 0 && *plevel <= 9)
+                break;
+            code = gs_error_rangecheck;
+        default:
+            ecode = code;
+            param_signal_error(plist, param_name, ecode);
+        case 1:
+            break;
+    }
+    switch (code = param_read_string(plist, (param_name = "PNGFilter"), &fstr)) {
+        case 0:
+            for (i = 0; i < countof(png_filter_names); i++)
+                if (fstr.size == strlen(png_filter_names[i]) &&
+                    !memcmp(fstr.data, png_filter_names[i], fstr.size))
+                    break;
+            if (i < countof(png_filter_names)) {
+                *pfilter = i;
+                break;
+            }
+            code = gs_error_rangecheck;
+        default:
+            ecode = code;
+            param_signal_error(plist, param_name, ecode);
+        case 1:
+            break;
+    }
+    return ecode;
+}
+
+static int
+png_get_params(gx_device * dev, gs_param_list * plist)
+{
+    int code = gdev_prn_get_params(dev, plist);
+
+    if (code >= 0)
+        code = png_get_compression_params((gx_device_png *)dev, plist);
+    return code;
+}
+
+static int
+png_put_params(gx_device * dev, gs_param_list * plist)
+{
+    gx_device_png *pdev = (gx_device_png *)dev;
+    int level = pdev->compression_level;
+    int filter = pdev->filter;
+    int code, ecode;
+
+    ecode = png_read_compression_params(plist, &level, &filter);
+    code = gdev_prn_put_params(dev, plist);
+    if (code < 0)
+        ecode = code;
+    if (ecode >= 0) {
+        pdev->compression_level = level;
+        pdev->filter = filter;
+    }
+    return ecode;
+}
+
 static int
 png_get_params_downscale(gx_device * dev, gs_param_list * plist)
 {
@@ -311,6 +422,8 @@ png_get_params_downscale(gx_device * dev, gs_param_list * plist)
         pdev->downscale_factor = 1;
     if ((code = param_write_int(plist, "DownScaleFactor", &pdev->downscale_factor)) < 0)
         ecode = code;
+    if ((code = png_get_compression_params(pdev, plist)) < 0)
+        ecode = code;
 
     code = gdev_prn_get_params(dev, plist);
     if (code < 0)
@@ -325,6 +438,8 @@ png_put_params_downscale(gx_device *dev, gs_param_list *plist)
     gx_device_png *pdev = (gx_device_png *)dev;
     int code, ecode;
     int dsf = pdev->downscale_factor;
+    int level = pdev->compression_level;
+    int filter = pdev->filter;
     const char *param_name;
     
     ecode = 0;
@@ -339,12 +454,16 @@ png_put_params_downscale(gx_device *dev, gs_param_list *plist)
         case 1:
             break;
     }
+    if ((code = png_read_compression_params(plist, &level, &filter)) < 0)
+        ecode = code;
 
     code = gdev_prn_put_params(dev, plist);
     if (code < 0)
         ecode = code;
 
     pdev->downscale_factor = dsf;
+    pdev->compression_level = level;
+    pdev->filter = filter;
 
     return ecode;
 }
@@ -396,6 +515,374 @@ png_put_params_downscale_mfs(gx_device *dev, gs_param_list *plist)
 }
 
 
+/* ------ Parallel compression ------ */
+
+/*
+ * When the device asks for more than one rendering thread, the image data
+ * is compressed pigz-style: the rows are split into chunks, and each chunk
+ * is filtered and deflated on a thread of its own.  Every chunk but the
+ * last ends with a sync flush, so that the raw deflate streams can simply
+ * be concatenated, and each chunk uses the last 32K of the data before it
+ * as a preset dictionary, so that little is lost at the seams.  The zlib
+ * header and the combined Adler-32 of the chunks make the whole into one
+ * zlib stream, which is written as one IDAT per chunk.
+ */
+#define PNG_CHUNK_BYTES 262144	/* uncompressed data per chunk */
+#define PNG_DICT_BYTES 32768	/* the deflate window */
+
+typedef struct png_parallel_s {
+    uint rowbytes;
+    uint bpp;			/* bytes per complete pixel, at least 1 */
+    int filter;			/* index in png_filter_names */
+    int level;
+    int strategy;
+} png_parallel_t;
+
+typedef struct png_chunk_job_s {
+    const png_parallel_t *pp;
+    uint rows;
+    byte *raw;			/* rows after the libpng transformations */
+    const byte *prior;		/* the row above the first one */
+    byte *filtered;		/* filter type byte + filtered row, per row */
+    byte *scratch;		/* for choosing the filter */
+    const byte *dict;
+    uint dict_len;
+    byte *out;
+    uint out_size;
+    uint out_len;
+    bool first, last;
+    uLong adler;
+    int code;
+    gp_thread_id thread;
+} png_chunk_job_t;
+
+static inline int
+png_paeth(int a, int b, int c)
+{
+    int p = b - c, q = a - c;
+    int pa = any_abs(p), pb = any_abs(q), pc = any_abs(p + q);
+
+    return (pa <= pb && pa <= pc ? a : pb <= pc ? b : c);
+}
+
+/* Filter one row.  out[0] gets the filter type. */
+static void
+png_filter_row(int type, const byte *row, const byte *prior, byte *out,
+               uint rowbytes, uint bpp)
+{
+    uint i;
+
+    *out++ = type;
+    switch (type) {
+        case PNG_FILTER_VALUE_NONE:
+            memcpy(out, row, rowbytes);
+            break;
+        case PNG_FILTER_VALUE_SUB:
+            for (i = 0; i < bpp && i < rowbytes; i++)
+                out[i] = row[i];
+            for (; i < rowbytes; i++)
+                out[i] = row[i] - row[i - bpp];
+            break;
+        case PNG_FILTER_VALUE_UP:
+            for (i = 0; i < rowbytes; i++)
+                out[i] = row[i] - prior[i];
+            break;
+        case PNG_FILTER_VALUE_AVG:
+            for (i = 0; i < bpp && i < rowbytes; i++)
+                out[i] = row[i] - (prior[i] >> 1);
+            for (; i < rowbytes; i++)
+                out[i] = row[i] - ((row[i - bpp] + prior[i]) >> 1);
+            break;
+        case PNG_FILTER_VALUE_PAETH:
+            for (i = 0; i < bpp && i < rowbytes; i++)
+                out[i] = row[i] - prior[i];
+            for (; i < rowbytes; i++)
+                out[i] = row[i] -
+                    png_paeth(row[i - bpp], prior[i], prior[i - bpp]);
+            break;
+    }
+}
+
+/* The libpng heuristic: the sum of the filtered bytes, taken as signed. */
+static ulong
+png_filter_cost(const byte *out, uint rowbytes)
+{
+    ulong sum = 0;
+    uint i;
+
+    for (i = 1; i <= rowbytes; i++)
+        sum += (out[i] < 128 ? out[i] : 256 - out[i]);
+    return sum;
+}
+
+/*
+ * Filter one chunk.  This runs in a worker thread.  All the chunks of a
+ * batch are filtered before any is deflated, since each one's dictionary
+ * is the filtered tail of the one before.
+ */
+static void
+png_filter_chunk(void *arg)
+{
+    png_chunk_job_t *job = (png_chunk_job_t *)arg;
+    const png_parallel_t *pp = job->pp;
+    uint rowbytes = pp->rowbytes;
+    uint r;
+
+    for (r = 0; r < job->rows; r++) {
+        const byte *row = job->raw + r * rowbytes;
+        const byte *prior = (r == 0 ? job->prior : row - rowbytes);
+        byte *dest = job->filtered + r * (rowbytes + 1);
+
+        if (pp->filter > 0)
+            png_filter_row(pp->filter - 1, row, prior, dest, rowbytes,
+                           pp->bpp);
+        else {
+            int type;
+            ulong best;
+
+            png_filter_row(PNG_FILTER_VALUE_NONE, row, prior, dest,
+                           rowbytes, pp->bpp);
+            best = png_filter_cost(dest, rowbytes);
+            for (type = PNG_FILTER_VALUE_SUB; type < PNG_FILTER_VALUE_LAST;
+                 type++) {
+                ulong cost;
+
+                png_filter_row(type, row, prior, job->scratch, rowbytes,
+                               pp->bpp);
+                cost = png_filter_cost(job->scratch, rowbytes);
+                if (cost < best) {
+                    best = cost;
+                    memcpy(dest, job->scratch, rowbytes + 1);
+                }
+            }
+        }
+    }
+    job->adler = adler32(adler32(0L, Z_NULL, 0), job->filtered,
+                         job->rows * (rowbytes + 1));
+}
+
+/* Deflate one filtered chunk.  This runs in a worker thread. */
+static void
+png_deflate_chunk(void *arg)
+{
+    png_chunk_job_t *job = (png_chunk_job_t *)arg;
+    const png_parallel_t *pp = job->pp;
+    uint len = job->rows * (pp->rowbytes + 1);
+    byte *out = job->out;
+    z_stream zs;
+    int flush = (job->last ? Z_FINISH : Z_SYNC_FLUSH);
+    int zcode;
+
+    job->code = gs_note_error(gs_error_ioerror);
+    memset(&zs, 0, sizeof(zs));
+    if (deflateInit2(&zs, pp->level, Z_DEFLATED, -MAX_WBITS, 8,
+                     pp->strategy) != Z_OK)
+        return;
+    if (job->dict_len != 0 &&
+        deflateSetDictionary(&zs, job->dict, job->dict_len) != Z_OK)
+        goto done;
+    if (job->first) {
+        /* The zlib header, as deflateInit would write it. */
+        uint header = (Z_DEFLATED + ((MAX_WBITS - 8) << 4)) << 8;
+        int level_flags = (pp->level < 2 ? 0 : pp->level < 6 ? 1 :
+                           pp->level == 6 ? 2 : 3);
+
+        header |= level_flags << 6;
+        header += 31 - (header % 31);
+        *out++ = (byte)(header >> 8);
+        *out++ = (byte)header;
+    }
+    zs.next_in = job->filtered;
+    zs.avail_in = len;
+    zs.next_out = out;
+    zs.avail_out = job->out_size - (out - job->out) - 4; /* room for Adler */
+    zcode = deflate(&zs, flush);
+    if (job->last ? zcode != Z_STREAM_END :
+        zcode != Z_OK || zs.avail_in != 0 || zs.avail_out == 0)
+        goto done;
+    job->out_len = zs.next_out - job->out;
+    job->code = 0;
+done:
+    deflateEnd(&zs);
+}
+
+/* Run a procedure on each job, falling back to this thread if need be. */
+static void
+png_run_jobs(gp_thread_creation_callback_t proc, png_chunk_job_t *jobs, int n)
+{
+    int i;
+
+    for (i = 0; i < n; i++)
+        if (gp_thread_start(proc, &jobs[i], &jobs[i].thread) < 0)
+            proc(&jobs[i]);
+    for (i = 0; i < n; i++) {
+        gp_thread_finish(jobs[i].thread);
+        jobs[i].thread = NULL;
+    }
+}
+
+/* Write the image data, compressing it in parallel, and the IEND chunk. */
+static int
+png_write_image_parallel(gx_device_png *pdev, png_struct *png_ptr,
+                         png_info *info_ptr, gx_downscaler_t *ds,
+                         byte *row, int raster, png_uint_32 height,
+                         bool invert)
+{
+    gs_memory_t *mem = pdev->memory;
+    int num_threads = pdev->num_render_threads_requested;
+    png_parallel_t pp;
+    png_chunk_job_t *jobs;
+    byte *prior = NULL, *dict = NULL;
+    uint dict_len = 0;
+    uint chunk_rows, chunk_len;
+    int color_type = png_get_color_type(png_ptr, info_ptr);
+    int bit_depth = png_get_bit_depth(png_ptr, info_ptr);
+    uLong adler = adler32(0L, Z_NULL, 0);
+    png_uint_32 y = 0;
+    int code = 0;
+    int i;
+
+    pp.rowbytes = png_get_rowbytes(png_ptr, info_ptr);
+    pp.bpp = max(1, (bit_depth * png_get_channels(png_ptr, info_ptr)) >> 3);
+    pp.filter = pdev->filter;
+    /* As libpng, don't filter palette images or depths below 8. */
+    if (pp.filter == 0 &&
+        (color_type == PNG_COLOR_TYPE_PALETTE || bit_depth < 8))
+        pp.filter = 1 + PNG_FILTER_VALUE_NONE;
+    pp.level = (pdev->compression_level > 0 ? pdev->compression_level :
+                Z_DEFAULT_COMPRESSION);
+    if (pp.level == Z_DEFAULT_COMPRESSION)
+        pp.level = 6;
+    pp.strategy = (pp.filter == 1 + PNG_FILTER_VALUE_NONE ?
+                   Z_DEFAULT_STRATEGY : Z_FILTERED);
+    chunk_rows = max(1, PNG_CHUNK_BYTES / pp.rowbytes);
+    chunk_len = chunk_rows * (pp.rowbytes + 1);
+
+    jobs = (png_chunk_job_t *)gs_alloc_bytes(mem,
+                                num_threads * sizeof(png_chunk_job_t),
+                                "png_write_image_parallel(jobs)");
+    if (jobs == NULL)
+        return_error(gs_error_VMerror);
+    memset(jobs, 0, num_threads * sizeof(png_chunk_job_t));
+    prior = gs_alloc_bytes(mem, pp.rowbytes, "png_write_image_parallel");
+    dict = gs_alloc_bytes(mem, PNG_DICT_BYTES, "png_write_image_parallel");
+    if (prior == NULL || dict == NULL)
+        code = gs_note_error(gs_error_VMerror);
+    for (i = 0; i < num_threads && code >= 0; i++) {
+        png_chunk_job_t *job = &jobs[i];
+
+        job->pp = &pp;
+        /* The bound is compressBound's, plus the header and the Adler. */
+        job->out_size = chunk_len + (chunk_len >> 12) + (chunk_len >> 14) +
+            (chunk_len >> 25) + 13 + 16;
+        job->raw = gs_alloc_bytes(mem, chunk_rows * pp.rowbytes,
+                                  "png_write_image_parallel(raw)");
+        job->filtered = gs_alloc_bytes(mem, chunk_len,
+                                       "png_write_image_parallel(filtered)");
+        job->scratch = gs_alloc_bytes(mem, pp.rowbytes + 1,
+                                      "png_write_image_parallel(scratch)");
+        job->out = gs_alloc_bytes(mem, job->out_size,
+                                  "png_write_image_parallel(out)");
+        if (job->raw == NULL || job->filtered == NULL ||
+            job->scratch == NULL || job->out == NULL)
+            code = gs_note_error(gs_error_VMerror);
+    }
+    if (code >= 0)
+        memset(prior, 0, pp.rowbytes);
+
+    while (y < height && code >= 0) {
+        int n;
+
+        /* Collect the rows of a batch of chunks. */
+        for (n = 0; n < num_threads && y < height; n++) {
+            png_chunk_job_t *job = &jobs[n];
+            uint r;
+
+            job->rows = min(chunk_rows, height - y);
+            for (r = 0; r < job->rows; r++, y++) {
+                byte *dest = job->raw + r * pp.rowbytes;
+                uint x;
+
+                gx_downscaler_copy_scan_lines(ds, y, row, raster);
+                memcpy(dest, row, pp.rowbytes);
+                /*
+                 * Do what png_set_invert_* does.  png_set_swap is called
+                 * before png_write_info sets the bit depth, so libpng
+                 * doesn't swap 16-bit samples, and neither do we.
+                 */
+                if (invert) {
+                    if (color_type == PNG_COLOR_TYPE_RGB_ALPHA)
+                        for (x = 3; x < pp.rowbytes; x += 4)
+                            dest[x] ^= 0xff;
+                    else
+                        for (x = 0; x < pp.rowbytes; x++)
+                            dest[x] ^= 0xff;
+                }
+            }
+            job->prior = (n == 0 ? prior :
+                          jobs[n - 1].raw + (jobs[n - 1].rows - 1) * pp.rowbytes);
+            if (n == 0) {
+                job->dict = dict;
+                job->dict_len = dict_len;
+            } else {
+                uint prev_len = jobs[n - 1].rows * (pp.rowbytes + 1);
+
+                job->dict_len = min(prev_len, PNG_DICT_BYTES);
+                job->dict = jobs[n - 1].filtered + prev_len - job->dict_len;
+            }
+            job->first = (y == job->rows);
+            job->last = (y == height);
+        }
+        /* Compress them. */
+        png_run_jobs(png_filter_chunk, jobs, n);
+        png_run_jobs(png_deflate_chunk, jobs, n);
+        /* Write them in order. */
+        for (i = 0; i < n && code >= 0; i++) {
+            png_chunk_job_t *job = &jobs[i];
+
+            if (job->code < 0) {
+                code = job->code;
+                break;
+            }
+            adler = adler32_combine(adler, job->adler,
+                                    job->rows * (pp.rowbytes + 1));
+            if (job->last) {
+                job->out[job->out_len++] = (byte)(adler >> 24);
+                job->out[job->out_len++] = (byte)(adler >> 16);
+                job->out[job->out_len++] = (byte)(adler >> 8);
+                job->out[job->out_len++] = (byte)adler;
+            }
+            png_write_chunk(png_ptr, (png_const_bytep)"IDAT", job->out,
+                            job->out_len);
+        }
+        /* Carry the last row and the window over to the next batch. */
+        if (code >= 0 && n > 0) {
+            png_chunk_job_t *job = &jobs[n - 1];
+            uint len = job->rows * (pp.rowbytes + 1);
+
+            memcpy(prior, job->raw + (job->rows - 1) * pp.rowbytes,
+                   pp.rowbytes);
+            dict_len = min(len, PNG_DICT_BYTES);
+            memcpy(dict, job->filtered + len - dict_len, dict_len);
+        }
+    }
+    if (code >= 0)
+        png_write_chunk(png_ptr, (png_const_bytep)"IEND", NULL, 0);
+
+    for (i = 0; i < num_threads; i++) {
+        gs_free_object(mem, jobs[i].raw, "png_write_image_parallel(raw)");
+        gs_free_object(mem, jobs[i].filtered,
+                       "png_write_image_parallel(filtered)");
+        gs_free_object(mem, jobs[i].scratch,
+                       "png_write_image_parallel(scratch)");
+        gs_free_object(mem, jobs[i].out, "png_write_image_parallel(out)");
+    }
+    gs_free_object(mem, jobs, "png_write_image_parallel(jobs)");
+    gs_free_object(mem, prior, "png_write_image_parallel");
+    gs_free_object(mem, dict, "png_write_image_parallel");
+    return code;
+}
+
 /* Write out a page in PNG format. */
 /* This routine is used for all formats. */
 static int
@@ -436,6 +923,7 @@ do_png_print_page(gx_device_png * pdev, FILE * file, bool monod)
     png_color *palettep;
     png_uint_16 num_palette;
     png_uint_32 valid = 0;
+    bool parallel = false;
 
     /* Sanity check params */
     if (factor < 1)
@@ -629,6 +1117,11 @@ do_png_print_page(gx_device_png * pdev, FILE * file, bool monod)
     if (bg_needed) {
         png_set_bKGD(png_ptr, info_ptr, &background);
     }
+    if (pdev->compression_level > 0)
+        png_set_compression_level(png_ptr, pdev->compression_level);
+    if (pdev->filter > 0)
+        png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE,
+                       png_filter_masks[pdev->filter]);
 #if defined(ARCH_IS_BIG_ENDIAN) && (!ARCH_IS_BIG_ENDIAN)
     if (endian_swap) {
         png_set_swap(png_ptr);
@@ -654,15 +1147,24 @@ do_png_print_page(gx_device_png * pdev, FILE * file, bool monod)
     if (code >= 0)
     {
         /* Write the contents of the image. */
-        for (y = 0; y < height; y++) {
-            gx_downscaler_copy_scan_lines(&ds, y, row, raster);
-            png_write_rows(png_ptr, &row, 1);
-        }
+        parallel = pdev->num_render_threads_requested > 1 &&
+            (ulong)png_get_rowbytes(png_ptr, info_ptr) * height >
+                PNG_CHUNK_BYTES;
+        if (parallel)
+            code = png_write_image_parallel(pdev, png_ptr, info_ptr, &ds,
+                                            row, raster, height,
+                                            invert);
+        else
+            for (y = 0; y < height; y++) {
+                gx_downscaler_copy_scan_lines(&ds, y, row, raster);
+                png_write_rows(png_ptr, &row, 1);
+            }
         gx_downscaler_fin(&ds);
     }
 
     /* write the rest of the file */
-    png_write_end(png_ptr, info_ptr);
+    if (!parallel)
+        png_write_end(png_ptr, info_ptr);
 
 #if PNG_LIBPNG_VER_MINOR >= 5
 #else
@@ -747,6 +1249,8 @@ pngalpha_put_params(gx_device * pdev, gs_param_list * plist)
 {
     gx_device_pngalpha *ppdev = (gx_device_pngalpha *)pdev;
     int background;
+    int level = ppdev->compression_level;
+    int filter = ppdev->filter;
     int code;
 
     /* BackgroundColor in format 16#RRGGBB is used for bKGD chunk */
@@ -761,10 +1265,16 @@ pngalpha_put_params(gx_device * pdev, gs_param_list * plist)
             param_signal_error(plist, "BackgroundColor", code);
             break;
     }
+    if (code == 0)
+        code = png_read_compression_params(plist, &level, &filter);
 
     if (code == 0) {
         code = gdev_prn_put_params(pdev, plist);
     }
+    if (code == 0) {
+        ppdev->compression_level = level;
+        ppdev->filter = filter;
+    }
     return code;
 }
 
@@ -777,6 +1287,8 @@ pngalpha_get_params(gx_device * pdev, gs_param_list * plist)
     if (code >= 0)
         code = param_write_int(plist, "BackgroundColor",
                                 &(ppdev->background));
+    if (code >= 0)
+        code = png_get_compression_params((gx_device_png *)pdev, plist);
     return code;
 }
 
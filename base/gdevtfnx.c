@@ -137,10 +137,17 @@ tiff12_print_page(gx_device_printer * pdev, FILE * file)
         int y;
         int size = gdev_prn_raster(pdev);
         byte *data = gs_alloc_bytes(pdev->memory, size, "tiff12_print_page");
+        tiff_strip_writer *writer;
 
         if (data == 0)
             return_error(gs_error_VMerror);
 
+        code = tiff_strip_writer_begin(pdev, tfdev->tif, &writer);
+        if (code < 0) {
+            gs_free_object(pdev->memory, data, "tiff12_print_page");
+            return code;
+        }
+
         memset(data, 0, size);
 
         for (y = 0; y < pdev->height; ++y) {
@@ -159,7 +166,15 @@ tiff12_print_page(gx_device_printer * pdev, FILE * file)
                 dest[1] = (src[2] & 0xf0) | (src[3] >> 4);
                 dest[2] = (src[4] & 0xf0) | (src[5] >> 4);
             }
-            TIFFWriteScanline(tfdev->tif, data, y, 0);
+            code = tiff_write_scanline(writer, tfdev->tif, data, y);
+            if (code < 0)
+                break;
+        }
+        {
+            int code1 = tiff_strip_writer_end(writer);
+
+            if (code >= 0)
+                code = code1;
         }
         gs_free_object(pdev->memory, data, "tiff12_print_page");
 
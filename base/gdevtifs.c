@@ -25,6 +25,7 @@
 #include "gdevprn.h"
 #include "minftrsz.h"
 #include "gxdownscale.h"
+#include "gpsync.h"
 
 #include <tiffio.h>
 
@@ -385,10 +386,381 @@ int tiff_set_fields_for_printer(gx_device_printer *pdev,
     return 0;
 }
 
+/* ------ Parallel strip compression ------ */
+
+/*
+ * When the device asks for more than one rendering thread, the rows of a
+ * page are collected into whole strips, and each strip is compressed by
+ * libtiff in a worker thread, into a TIFF file of its own held in memory.
+ * The compressed strips are then copied to the output file in order with
+ * TIFFWriteRawStrip.  Since libtiff starts each strip afresh, the file is
+ * the same as one written a scanline at a time.
+ *
+ * While one batch of strips is being compressed, the next one is filled,
+ * so there are 2 batches of NumRenderingThreads strips.
+ */
+
+/* A TIFF file in memory.  This is used by the worker threads, so it is */
+/* allocated with libtiff's (thread-safe) allocator. */
+typedef struct tiff_mem_file_s {
+    byte *data;
+    toff_t size;
+    toff_t alloc;
+    toff_t pos;
+} tiff_mem_file;
+
+typedef struct tiff_strip_job_s {
+    uint32 strip;               /* strip number in the output file */
+    int rows;                   /* # of rows in the strip, 0 if unused */
+    byte *data;                 /* uncompressed rows */
+    tiff_mem_file mf;           /* the compressed strip */
+    toff_t offset;              /* offset of the strip in mf */
+    tmsize_t count;             /* size of the compressed strip */
+    const struct tiff_strip_writer_s *writer;
+    gp_thread_id thread;
+} tiff_strip_job;
+
+struct tiff_strip_writer_s {
+    gs_memory_t *memory;
+    TIFF *tif;
+    int num_threads;
+    tmsize_t raster;            /* bytes per row */
+    int rows_per_strip;
+    int height;
+    /* The fields needed to compress a strip like the output file. */
+    uint32 width;
+    uint16 bits_per_sample;
+    uint16 samples_per_pixel;
+    uint16 photometric;
+    uint16 fill_order;
+    uint16 compression;
+    uint32 fax_options;
+    float y_resolution;         /* the G3 2-D K factor depends on this */
+    uint16 resolution_unit;
+    bool big_endian;
+    /* The current batch, and the position in it. */
+    int batch;
+    int job;
+    int row;                    /* row within the current strip */
+    uint32 next_strip;
+    bool in_flight[2];
+    tiff_strip_job *jobs[2];
+};
+
+static tmsize_t
+tiff_mem_read(thandle_t h, void *buf, tmsize_t size)
+{
+    tiff_mem_file *mf = (tiff_mem_file *)h;
+
+    if (mf->pos >= mf->size)
+        return 0;
+    if (size > mf->size - mf->pos)
+        size = mf->size - mf->pos;
+    memcpy(buf, mf->data + mf->pos, size);
+    mf->pos += size;
+    return size;
+}
+
+static tmsize_t
+tiff_mem_write(thandle_t h, void *buf, tmsize_t size)
+{
+    tiff_mem_file *mf = (tiff_mem_file *)h;
+
+    if (mf->pos + size > mf->alloc) {
+        toff_t alloc = max(mf->alloc * 2, mf->pos + size);
+        byte *data = _TIFFrealloc(mf->data, alloc);
+
+        if (data == NULL)
+            return -1;
+        mf->data = data;
+        mf->alloc = alloc;
+    }
+    memcpy(mf->data + mf->pos, buf, size);
+    mf->pos += size;
+    if (mf->pos > mf->size)
+        mf->size = mf->pos;
+    return size;
+}
+
+static toff_t
+tiff_mem_seek(thandle_t h, toff_t offset, int whence)
+{
+    tiff_mem_file *mf = (tiff_mem_file *)h;
+
+    switch (whence) {
+        case SEEK_CUR:
+            offset += mf->pos;
+            break;
+        case SEEK_END:
+            offset += mf->size;
+            break;
+    }
+    mf->pos = offset;
+    return offset;
+}
+
+static int
+tiff_mem_close(thandle_t h)
+{
+    return 0;
+}
+
+static toff_t
+tiff_mem_size(thandle_t h)
+{
+    return ((tiff_mem_file *)h)->size;
+}
+
+static int
+tiff_mem_map(thandle_t h, void **base, toff_t *size)
+{
+    return 0;
+}
+
+static void
+tiff_mem_unmap(thandle_t h, void *base, toff_t size)
+{
+}
+
+/* Compress one strip.  This runs in a worker thread. */
+static void
+tiff_compress_strip(void *arg)
+{
+    tiff_strip_job *job = (tiff_strip_job *)arg;
+    const struct tiff_strip_writer_s *w = job->writer;
+    TIFF *mtif;
+    uint64 *offsets, *counts;
+
+    job->mf.size = job->mf.pos = 0;
+    job->count = -1;
+    mtif = TIFFClientOpen("strip", (w->big_endian ? "wb" : "wl"),
+                          (thandle_t)&job->mf, tiff_mem_read, tiff_mem_write,
+                          tiff_mem_seek, tiff_mem_close, tiff_mem_size,
+                          tiff_mem_map, tiff_mem_unmap);
+    if (mtif == NULL)
+        return;
+    TIFFSetField(mtif, TIFFTAG_IMAGEWIDTH, w->width);
+    TIFFSetField(mtif, TIFFTAG_IMAGELENGTH, (uint32)job->rows);
+    TIFFSetField(mtif, TIFFTAG_ROWSPERSTRIP, (uint32)job->rows);
+    TIFFSetField(mtif, TIFFTAG_BITSPERSAMPLE, w->bits_per_sample);
+    TIFFSetField(mtif, TIFFTAG_SAMPLESPERPIXEL, w->samples_per_pixel);
+    TIFFSetField(mtif, TIFFTAG_PHOTOMETRIC, w->photometric);
+    TIFFSetField(mtif, TIFFTAG_FILLORDER, w->fill_order);
+    TIFFSetField(mtif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+    TIFFSetField(mtif, TIFFTAG_COMPRESSION, w->compression);
+    TIFFSetField(mtif, TIFFTAG_YRESOLUTION, w->y_resolution);
+    TIFFSetField(mtif, TIFFTAG_RESOLUTIONUNIT, w->resolution_unit);
+    if (w->compression == COMPRESSION_CCITTFAX3)
+        TIFFSetField(mtif, TIFFTAG_GROUP3OPTIONS, w->fax_options);
+    else if (w->compression == COMPRESSION_CCITTFAX4)
+        TIFFSetField(mtif, TIFFTAG_GROUP4OPTIONS, w->fax_options);
+    if (TIFFWriteEncodedStrip(mtif, 0, job->data,
+                              w->raster * job->rows) >= 0 &&
+        TIFFGetField(mtif, TIFFTAG_STRIPOFFSETS, &offsets) &&
+        TIFFGetField(mtif, TIFFTAG_STRIPBYTECOUNTS, &counts)) {
+        job->offset = offsets[0];
+        job->count = (tmsize_t)counts[0];
+    }
+    TIFFCleanup(mtif);
+}
+
+/* Start compressing the strips of a batch. */
+static void
+tiff_strip_batch_start(tiff_strip_writer *w, int batch)
+{
+    int i;
+
+    for (i = 0; i < w->num_threads; i++) {
+        tiff_strip_job *job = &w->jobs[batch][i];
+
+        if (job->rows == 0)
+            break;
+        job->writer = w;
+        /* If we can't start a thread, do the work here. */
+        if (gp_thread_start(tiff_compress_strip, job, &job->thread) < 0)
+            tiff_compress_strip(job);
+    }
+    w->in_flight[batch] = true;
+}
+
+/* Wait for the strips of a batch, and write them to the output file. */
+static int
+tiff_strip_batch_finish(tiff_strip_writer *w, int batch)
+{
+    int code = 0;
+    int i;
+
+    if (!w->in_flight[batch])
+        return 0;
+    for (i = 0; i < w->num_threads; i++) {
+        tiff_strip_job *job = &w->jobs[batch][i];
+
+        if (job->rows == 0)
+            break;
+        if (job->thread) {
+            gp_thread_finish(job->thread);
+            job->thread = NULL;
+        }
+        if (code < 0)
+            ;
+        else if (job->count < 0 ||
+                 TIFFWriteRawStrip(w->tif, job->strip,
+                                   job->mf.data + job->offset,
+                                   job->count) < 0)
+            code = gs_note_error(gs_error_ioerror);
+        job->rows = 0;
+    }
+    w->in_flight[batch] = false;
+    return code;
+}
+
+/*
+ * Set up parallel compression for a page, if the device asks for it and
+ * there is more than one strip to compress.  Otherwise set *pwriter to
+ * NULL, so that tiff_write_scanline just calls TIFFWriteScanline.
+ */
 int
-tiff_print_page(gx_device_printer *dev, TIFF *tif, int min_feature_size)
+tiff_strip_writer_begin(gx_device_printer *dev, TIFF *tif,
+                        tiff_strip_writer **pwriter)
+{
+    gs_memory_t *mem = dev->memory;
+    int num_threads = dev->num_render_threads_requested;
+    tiff_strip_writer *w;
+    uint32 rows_per_strip, height, width;
+    uint16 bps, spp, photometric, fill_order, compression, planar, resunit;
+    uint32 fax_options = 0;
+    float yres = 0;
+    int b, i;
+
+    *pwriter = NULL;
+    if (num_threads < 2 ||
+        !TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &width) ||
+        !TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &height) ||
+        !TIFFGetField(tif, TIFFTAG_ROWSPERSTRIP, &rows_per_strip) ||
+        rows_per_strip >= height)
+        return 0;
+    TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE, &bps);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &spp);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_FILLORDER, &fill_order);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_COMPRESSION, &compression);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_PLANARCONFIG, &planar);
+    TIFFGetFieldDefaulted(tif, TIFFTAG_RESOLUTIONUNIT, &resunit);
+    TIFFGetField(tif, TIFFTAG_YRESOLUTION, &yres);
+    if (!TIFFGetField(tif, TIFFTAG_PHOTOMETRIC, &photometric) ||
+        planar != PLANARCONFIG_CONTIG)
+        return 0;
+    if (compression == COMPRESSION_CCITTFAX3)
+        TIFFGetFieldDefaulted(tif, TIFFTAG_GROUP3OPTIONS, &fax_options);
+    else if (compression == COMPRESSION_CCITTFAX4)
+        TIFFGetFieldDefaulted(tif, TIFFTAG_GROUP4OPTIONS, &fax_options);
+
+    w = (tiff_strip_writer *)gs_alloc_bytes(mem, sizeof(*w),
+                                           "tiff_strip_writer_begin");
+    if (w == NULL)
+        return_error(gs_error_VMerror);
+    memset(w, 0, sizeof(*w));
+    w->memory = mem;
+    w->tif = tif;
+    w->num_threads = num_threads;
+    w->raster = TIFFScanlineSize(tif);
+    w->rows_per_strip = rows_per_strip;
+    w->height = height;
+    w->width = width;
+    w->bits_per_sample = bps;
+    w->samples_per_pixel = spp;
+    w->photometric = photometric;
+    w->fill_order = fill_order;
+    w->compression = compression;
+    w->fax_options = fax_options;
+    w->y_resolution = yres;
+    w->resolution_unit = resunit;
+    w->big_endian = TIFFIsBigEndian(tif);
+    for (b = 0; b < 2; b++) {
+        w->jobs[b] = (tiff_strip_job *)
+            gs_alloc_bytes(mem, num_threads * sizeof(tiff_strip_job),
+                           "tiff_strip_writer_begin(jobs)");
+        if (w->jobs[b] == NULL)
+            goto fail;
+        memset(w->jobs[b], 0, num_threads * sizeof(tiff_strip_job));
+        for (i = 0; i < num_threads; i++) {
+            w->jobs[b][i].data =
+                gs_alloc_bytes(mem, w->raster * rows_per_strip,
+                               "tiff_strip_writer_begin(data)");
+            if (w->jobs[b][i].data == NULL)
+                goto fail;
+        }
+    }
+    *pwriter = w;
+    return 0;
+fail:
+    tiff_strip_writer_end(w);
+    return_error(gs_error_VMerror);
+}
+
+/* Write the next row of the page. */
+int
+tiff_write_scanline(tiff_strip_writer *w, TIFF *tif, byte *data, int row)
 {
+    tiff_strip_job *job;
     int code = 0;
+
+    if (w == NULL)
+        return TIFFWriteScanline(tif, data, row, 0);
+    job = &w->jobs[w->batch][w->job];
+    memcpy(job->data + w->row * w->raster, data, w->raster);
+    if (++w->row < w->rows_per_strip && row + 1 < w->height)
+        return 0;
+    /* The strip is complete. */
+    job->strip = w->next_strip++;
+    job->rows = w->row;
+    w->row = 0;
+    if (++w->job < w->num_threads && row + 1 < w->height)
+        return 0;
+    /* So is the batch. */
+    tiff_strip_batch_start(w, w->batch);
+    w->batch ^= 1;
+    w->job = 0;
+    code = tiff_strip_batch_finish(w, w->batch);
+    return code;
+}
+
+/* Finish the page, and free the writer. */
+int
+tiff_strip_writer_end(tiff_strip_writer *w)
+{
+    int code = 0, code1;
+    int b, i;
+
+    if (w == NULL)
+        return 0;
+    /* Compress any strips that haven't been started yet. */
+    if (w->jobs[w->batch] != NULL && w->jobs[w->batch][0].rows != 0)
+        tiff_strip_batch_start(w, w->batch);
+    for (b = 0; b < 2; b++) {
+        /* The other batch was started first. */
+        code1 = tiff_strip_batch_finish(w, w->batch ^ 1 ^ b);
+        if (code >= 0)
+            code = code1;
+    }
+    for (b = 0; b < 2; b++) {
+        if (w->jobs[b] == NULL)
+            continue;
+        for (i = 0; i < w->num_threads; i++) {
+            if (w->jobs[b][i].mf.data != NULL)
+                _TIFFfree(w->jobs[b][i].mf.data);
+            gs_free_object(w->memory, w->jobs[b][i].data,
+                           "tiff_strip_writer_end(data)");
+        }
+        gs_free_object(w->memory, w->jobs[b], "tiff_strip_writer_end(jobs)");
+    }
+    gs_free_object(w->memory, w, "tiff_strip_writer_end");
+    return code;
+}
+
+int
+tiff_print_page(gx_device_printer *dev, TIFF *tif, int min_feature_size)
+{
+    int code = 0, code1;
     byte *data;
     int size = gdev_mem_bytes_per_scan_line((gx_device *)dev);
     int max_size = max(size, TIFFScanlineSize(tif));
@@ -397,6 +769,7 @@ tiff_print_page(gx_device_printer *dev, TIFF *tif, int min_feature_size)
     void *min_feature_data = NULL;
     int line_lag = 0;
     int filtered_count;
+    tiff_strip_writer *writer = NULL;
 
     data = gs_alloc_bytes(dev->memory, max_size, "tiff_print_page(data)");
     if (data == NULL)
@@ -412,6 +785,8 @@ tiff_print_page(gx_device_printer *dev, TIFF *tif, int min_feature_size)
     }
 
     code = TIFFCheckpointDirectory(tif);
+    if (code >= 0)
+        code = tiff_strip_writer_begin(dev, tif, &writer);
 
     memset(data, 0, max_size);
     for (row = 0; row < dev->height && code >= 0; row++) {
@@ -431,14 +806,17 @@ tiff_print_page(gx_device_printer *dev, TIFF *tif, int min_feature_size)
                                      dev->width * dev->color_info.num_components);
 #endif
 
-            code = TIFFWriteScanline(tif, data, row - line_lag, 0);
+            code = tiff_write_scanline(writer, tif, data, row - line_lag);
         }
     }
     for (row -= line_lag ; row < dev->height && code >= 0; row++)
     {
         filtered_count = min_feature_size_process(data, min_feature_data);
-        code = TIFFWriteScanline(tif, data, row, 0);
+        code = tiff_write_scanline(writer, tif, data, row);
     }
+    code1 = tiff_strip_writer_end(writer);
+    if (code >= 0)
+        code = code1;
 
     if (code >= 0)
         code = TIFFWriteDirectory(tif);
@@ -456,7 +834,7 @@ int
 tiff_downscale_and_print_page(gx_device_printer *dev, TIFF *tif, int factor,
                               int mfs, int aw, int bpc, int num_comps)
 {
-    int code = 0;
+    int code = 0, code1;
     byte *data = NULL;
     int size = gdev_mem_bytes_per_scan_line((gx_device *)dev);
     int max_size = max(size, TIFFScanlineSize(tif));
@@ -464,19 +842,27 @@ tiff_downscale_and_print_page(gx_device_printer *dev, TIFF *tif, int factor,
     // int width  = dev->width/factor;
     int height = dev->height/factor;
     gx_downscaler_t ds;
+    tiff_strip_writer *writer;
 
     code = TIFFCheckpointDirectory(tif);
     if (code < 0)
         return code;
 
+    code = tiff_strip_writer_begin(dev, tif, &writer);
+    if (code < 0)
+        return code;
+
     code = gx_downscaler_init(&ds, (gx_device *)dev, 8, bpc, num_comps,
                               factor, mfs, &fax_adjusted_width, aw);
-    if (code < 0)
+    if (code < 0) {
+        tiff_strip_writer_end(writer);
         return code;
+    }
 
     data = gs_alloc_bytes(dev->memory, max_size, "tiff_print_page(data)");
     if (data == NULL) {
         gx_downscaler_fin(&ds);
+        tiff_strip_writer_end(writer);
         return_error(gs_error_VMerror);
     }
 
@@ -485,10 +871,13 @@ tiff_downscale_and_print_page(gx_device_printer *dev, TIFF *tif, int factor,
         if (code < 0)
             break;
 
-        code = TIFFWriteScanline(tif, data, row, 0);
+        code = tiff_write_scanline(writer, tif, data, row);
         if (code < 0)
             break;
     }
+    code1 = tiff_strip_writer_end(writer);
+    if (code >= 0)
+        code = code1;
 
     if (code >= 0)
         code = TIFFWriteDirectory(tif);
@@ -57,6 +57,22 @@ int tiff_downscale_and_print_page(gx_device_printer *dev, TIFF *tif,
                                   int factor, int msf, int aw, int bpc,
                                   int num_comps);
 
+/*
+ * Write the rows of a page.  When the device asks for more than one
+ * rendering thread (NumRenderingThreads), tiff_strip_writer_begin sets
+ * up compressing several strips of the page at once in worker threads;
+ * otherwise it sets *pwriter to NULL, and tiff_write_scanline is just
+ * TIFFWriteScanline.  The rows must be written in order, and
+ * tiff_strip_writer_end must be called before TIFFWriteDirectory.
+ */
+typedef struct tiff_strip_writer_s tiff_strip_writer;
+
+int tiff_strip_writer_begin(gx_device_printer *dev, TIFF *tif,
+                            tiff_strip_writer **pwriter);
+int tiff_write_scanline(tiff_strip_writer *writer, TIFF *tif, byte *data,
+                        int row);
+int tiff_strip_writer_end(tiff_strip_writer *writer);
+
 /*
  * Sets the compression tag for TIFF and updates the rows_per_strip tag to
  * reflect max_strip_size under the new compression scheme.
@@ -1891,6 +1891,9 @@ tiffsep_print_page(gx_device_printer * pdev, FILE * file)
         int plane_index;
         int offset_plane = 0;
 
+        tiff_strip_writer *writers[GX_DEVICE_COLOR_MAX_COMPONENTS] = { 0 };
+        tiff_strip_writer *comp_writer = NULL;
+
         sep_line =
             gs_alloc_bytes(pdev->memory, cmyk_raster, "tiffsep_print_page");
 
@@ -1971,6 +1974,18 @@ tiffsep_print_page(gx_device_printer * pdev, FILE * file)
                                              num_comp, factor, mfs, 8, dst_bpc);
             if (code < 0)
                 goto cleanup;
+            for (comp_num = 0; comp_num < num_comp; comp_num++ ) {
+                code = tiff_strip_writer_begin(pdev, tfdev->tiff[comp_num],
+                                               &writers[comp_num]);
+                if (code < 0)
+                    goto cleanup;
+            }
+            if (dst_bpc == 8) {
+                code = tiff_strip_writer_begin(pdev, tfdev->tiff_comp,
+                                               &comp_writer);
+                if (code < 0)
+                    goto cleanup;
+            }
             for (y = 0; y < height; ++y) {
                 code = gx_downscaler_get_bits_rectangle(&ds, &params, y);
                 if (code < 0)
@@ -1986,17 +2001,36 @@ tiffsep_print_page(gx_device_printer * pdev, FILE * file)
                         src = params.data[comp_num];
                     for (pixel = 0; pixel < width; pixel++, dest++, src++)
                         *dest = MAX_COLOR_VALUE - *src;    /* Gray is additive */
-                    TIFFWriteScanline(tfdev->tiff[comp_num], (tdata_t)sep_line, y, 0);
+                    code = tiff_write_scanline(writers[comp_num],
+                                               tfdev->tiff[comp_num],
+                                               sep_line, y);
+                    if (code < 0)
+                        goto cleanup;
                 }
                 /* Write CMYK equivalent data (tiff32nc format) */
                 if (dst_bpc == 8) {
                     build_cmyk_raster_line_fromplanar(params, sep_line, width,
                                                       num_comp, cmyk_map, num_order,
                                                       tfdev);
-                    TIFFWriteScanline(tfdev->tiff_comp, (tdata_t)sep_line, y, 0);
+                    code = tiff_write_scanline(comp_writer, tfdev->tiff_comp,
+                                               sep_line, y);
+                    if (code < 0)
+                        goto cleanup;
                 }
             }
 cleanup:
+            for (comp_num = 0; comp_num < num_comp; comp_num++ ) {
+                int code2 = tiff_strip_writer_end(writers[comp_num]);
+
+                if (code >= 0)
+                    code = code2;
+            }
+            {
+                int code2 = tiff_strip_writer_end(comp_writer);
+
+                if (code >= 0)
+                    code = code2;
+            }
             if (num_order > 0) {
                 /* Free up the standard colorants if num_order was set.
                    In this process, we need to make sure that none of them
@@ -2155,6 +2189,7 @@ tiffsep1_print_page(gx_device_printer * pdev, FILE * file)
         /* the dithered_line is assumed to be 32-bit aligned by the alloc */
         uint32_t *dithered_line = (uint32_t *)gs_alloc_bytes(pdev->memory, dithered_raster,
                                 "tiffsep1_print_page");
+        tiff_strip_writer *writers[GX_DEVICE_COLOR_MAX_COMPONENTS] = { 0 };
 
         memset(planes, 0, sizeof(*planes) * GS_CLIENT_COLOR_MAX_COMPONENTS);
 
@@ -2180,8 +2215,13 @@ tiffsep1_print_page(gx_device_printer * pdev, FILE * file)
             goto cleanup;
         }
 
-        for (comp_num = 0; comp_num < num_comp; comp_num++ )
+        for (comp_num = 0; comp_num < num_comp; comp_num++ ) {
             TIFFCheckpointDirectory(tfdev->tiff[comp_num]);
+            code = tiff_strip_writer_begin(pdev, tfdev->tiff[comp_num],
+                                           &writers[comp_num]);
+            if (code < 0)
+                goto cleanup;
+        }
 
         rect.p.x = 0;
         rect.q.x = pdev->width;
@@ -2260,13 +2300,21 @@ tiffsep1_print_page(gx_device_printer * pdev, FILE * file)
                 }
 #endif /* USE_32_BIT_WRITES */
 #endif /* SKIP_HALFTONING_FOR_TIMING */
-                TIFFWriteScanline(tfdev->tiff[comp_num], (tdata_t)dithered_line, y, 0);
+                code = tiff_write_scanline(writers[comp_num],
+                                           tfdev->tiff[comp_num],
+                                           (byte *)dithered_line, y);
+                if (code < 0)
+                    goto cleanup;
             } /* end component loop */
         }
 
         /* Update the strip data */
         code1 = 0;
         for (comp_num = 0; comp_num < num_comp; comp_num++ ) {
+            code = tiff_strip_writer_end(writers[comp_num]);
+            writers[comp_num] = NULL;
+            if (code < 0)
+                code1 = code;
             TIFFWriteDirectory(tfdev->tiff[comp_num]);
 
             if (fmt) {
@@ -2287,6 +2335,8 @@ tiffsep1_print_page(gx_device_printer * pdev, FILE * file)
 
         /* free any allocations and exit with code */
 cleanup:
+        for (comp_num = 0; comp_num < num_comp; comp_num++)
+            tiff_strip_writer_end(writers[comp_num]);
         gs_free_object(pdev->memory, dithered_line, "tiffsep1_print_page");
         for (comp_num = 0; comp_num < num_comp; comp_num++) {
             gs_free_object(pdev->memory, planes[comp_num], "tiffsep1_print_page");
@@ -360,6 +360,16 @@ ialloc_reset_free(gs_ref_memory_t * mem)
  */
 #define FORCE_GC_LIMIT 8000000
 
+/*
+ * Each GC costs time in proportion to the amount of live data, so with a
+ * fixed vm_threshold a job that keeps a large object graph (such as the
+ * PDF interpreter's xref and object cache) spends most of its time
+ * re-marking the same objects.  Let the threshold grow with the amount
+ * that survived the previous GC, so that GC time per byte allocated
+ * stays bounded.  This is 1/2^GC_LIVE_GROWTH_SHIFT of the survivors.
+ */
+#define GC_LIVE_GROWTH_SHIFT 1
+
 /* Set the allocation limit after a change in one or more of */
 /* vm_threshold, max_vm, or enabled, or after a GC. */
 void
@@ -368,7 +378,8 @@ ialloc_set_limit(register gs_ref_memory_t * mem)
          * The following code is intended to set the limit so that
          * we stop allocating when allocated + previous_status.allocated
          * exceeds the lesser of max_vm or (if GC is enabled)
-         * gc_allocated + vm_threshold.
+         * gc_allocated + the larger of vm_threshold and a fraction
+         * of gc_allocated.
          */
     ulong max_allocated =
     (mem->gc_status.max_vm > mem->previous_status.allocated ?
@@ -376,7 +387,9 @@ ialloc_set_limit(register gs_ref_memory_t * mem)
      0);
 
     if (mem->gc_status.enabled) {
-        ulong limit = mem->gc_allocated + mem->gc_status.vm_threshold;
+        ulong growth = mem->gc_allocated >> GC_LIVE_GROWTH_SHIFT;
+        ulong limit = mem->gc_allocated +
+            max((ulong)mem->gc_status.vm_threshold, growth);
 
         if (limit < mem->previous_status.allocated)
             mem->limit = 0;
@@ -1957,6 +1970,37 @@ chunk_locate_ptr(const void *ptr, chunk_locator_t * clp)
     return !ptr_is_in_inner_chunk(ptr, cp);
 }
 
+/* ------ Statistics ------ */
+
+/*
+ * Walk the objects in the chunks of one allocator state and return chunk
+ * usage.  This is used only for reporting VM statistics: it looks at the
+ * chunks on demand rather than hooking the allocation procedures, so that
+ * allocation itself costs nothing extra.  The caller must close the current
+ * chunk first, and must enumerate the states of outer save levels itself.
+ */
+void
+ialloc_enum_stats(gs_ref_memory_t * mem, ialloc_enum_stats_proc_t proc,
+                  void *client, gs_chunk_stats_t * pcs)
+{
+    SCAN_MEM_CHUNKS(mem, cp)
+    {
+        pcs->chunks++;
+        pcs->free_gaps += cp->ctop - cp->cbot;
+        if (cp->outer)
+            pcs->free_gaps -= cp->cend - (byte *) cp->chead;
+        pcs->strings += cp->climit - cp->ctop;
+        SCAN_CHUNK_OBJECTS(cp)
+        DO_ALL
+            if (pre->o_type == &st_free)
+                pcs->free_objects += obj_size_round(size);
+            else if (proc != 0)
+                proc(client, pre->o_type, size);
+        END_OBJECTS_SCAN
+    }
+    END_CHUNKS_SCAN
+}
+
 /* ------ Debugging ------ */
 
 #ifdef DEBUG
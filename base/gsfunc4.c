@@ -29,16 +29,6 @@
 #include "spprint.h"
 #include "stream.h"
 
-typedef struct gs_function_PtCr_s {
-    gs_function_head_t head;
-    gs_function_PtCr_params_t params;
-    /* Define a bogus DataSource for get_function_info. */
-    gs_data_source_t data_source;
-} gs_function_PtCr_t;
-
-/* GC descriptor */
-private_st_function_PtCr();
-
 /* Define the maximum stack depth. */
 #define MAX_VSTACK 256		/* Max 100 is enough per PDF spec, but we use this
                                  * for DeviceN handling. Must be at least as large
@@ -60,6 +50,33 @@ typedef struct calc_value_s {
     } value;
 } calc_value_t;
 
+/*
+ * Straight-line programs (without if, ifelse and repeat) are compiled,
+ * when the function is built, into an array of typed operations.
+ * Since the types of all stack slots are known in advance, the compiled
+ * code needs no type dispatch and no stack checks, and operations on
+ * constants are folded.  If the compiled code meets an integer overflow
+ * or an error, it gives up and the function is evaluated by the
+ * interpreter, so that the result is always the same.
+ * The compiled code is allocated separately, for the size of the program.
+ */
+typedef struct calc_compiled_op_s {
+    int op;			/* gs_PtCr_opcode_t or gs_PtCr_typed_opcode_t */
+    calc_value_t value;		/* for PtCr_push */
+} calc_compiled_op_t;
+
+typedef struct gs_function_PtCr_s {
+    gs_function_head_t head;
+    gs_function_PtCr_params_t params;
+    /* Define a bogus DataSource for get_function_info. */
+    gs_data_source_t data_source;
+    int compiled_count;		/* < 0 if the program isn't compiled */
+    calc_compiled_op_t *compiled;	/* [compiled_count] */
+} gs_function_PtCr_t;
+
+/* GC descriptor */
+private_st_function_PtCr();
+
 /* Store a float. */
 static inline void
 store_float(calc_value_t *vsp, floatp f)
@@ -98,42 +115,32 @@ typedef enum {
         /* Miscellaneous */
 
     PtCr_no_op,
-    PtCr_typecheck
+    PtCr_typecheck,
 
-} gs_PtCr_typed_opcode_t;
+        /* Compiled code only */
 
-/* Evaluate a PostScript Calculator function. */
-static int
-fn_PtCr_evaluate(const gs_function_t *pfn_common, const float *in, float *out)
-{
-    const gs_function_PtCr_t *pfn = (const gs_function_PtCr_t *)pfn_common;
-    calc_value_t vstack_buf[2 + MAX_VSTACK + 1];
-    calc_value_t *vstack = &vstack_buf[1];
-    calc_value_t *vsp = vstack + pfn->params.m;
-    const byte *p = pfn->params.ops.data;
-    int repeat_count[MAX_PSC_FUNCTION_NESTING];
-    int repeat_proc_size[MAX_PSC_FUNCTION_NESTING];
-    int repeat_nesting_level = -1;
-    int i;
+    PtCr_push
 
-    /*
-     * Define the table for mapping explicit opcodes to typed opcodes.
-     * We index this table with the opcode and the types of the top 2
-     * values on the stack.
-     */
-    static const struct op_defn_s {
-        byte opcode[16];	/* 4 * type[-1] + type[0] */
-    } op_defn_table[] = {
-        /* Keep this consistent with opcodes in gsfunc4.h! */
+} gs_PtCr_typed_opcode_t;
+
+/*
+ * Define the table for mapping explicit opcodes to typed opcodes.
+ * We index this table with the opcode and the types of the top 2
+ * values on the stack.
+ */
+static const struct op_defn_s {
+    byte opcode[16];	/* 4 * type[-1] + type[0] */
+} op_defn_table[] = {
+    /* Keep this consistent with opcodes in gsfunc4.h! */
 
 #define O4(op) op,op,op,op
 #define E PtCr_typecheck
 #define E4 O4(E)
 #define N PtCr_no_op
-        /* 0-operand operators */
+    /* 0-operand operators */
 #define OP_NONE(op)\
   {{O4(op), O4(op), O4(op), O4(op)}}
-        /* 1-operand operators */
+    /* 1-operand operators */
 #define OP1(b, i, f)\
   {{E,b,i,f, E,b,i,f, E,b,i,f, E,b,i,f}}
 #define OP_NUM1(i, f)\
@@ -142,7 +149,7 @@ fn_PtCr_evaluate(const gs_function_t *pfn_common, const float *in, float *out)
   OP1(E, PtCr_int_to_float, f)
 #define OP_ANY1(op)\
   OP1(op, op, op)
-        /* 2-operand operators */
+    /* 2-operand operators */
 #define OP_NUM2(i, f)\
   {{E4, E4, E,E,i,PtCr_2nd_int_to_float, E,E,PtCr_int_to_float,f}}
 #define OP_INT_BOOL2(i)\
@@ -157,74 +164,578 @@ fn_PtCr_evaluate(const gs_function_t *pfn_common, const float *in, float *out)
 #define OP_ANY2(op)\
   {{E4, E,op,op,op, E,op,op,op, E,op,op,op}}
 
-    /* Arithmetic operators */
-
-        OP_NUM1(PtCr_abs_int, PtCr_abs),	/* abs */
-        OP_NUM2(PtCr_add_int, PtCr_add),	/* add */
-        OP_INT_BOOL2(PtCr_and),  /* and */
-        OP_MATH2(PtCr_atan),	/* atan */
-        OP_INT2(PtCr_bitshift),	/* bitshift */
-        OP_NUM1(N, PtCr_ceiling),	/* ceiling */
-        OP_MATH1(PtCr_cos),	/* cos */
-        OP_NUM1(N, PtCr_cvi),	/* cvi */
-        OP_NUM1(PtCr_int_to_float, N),	/* cvr */
-        OP_MATH2(PtCr_div),	/* div */
-        OP_MATH2(PtCr_exp),	/* exp */
-        OP_NUM1(N, PtCr_floor),	/* floor */
-        OP_INT2(PtCr_idiv),	/* idiv */
-        OP_MATH1(PtCr_ln),	/* ln */
-        OP_MATH1(PtCr_log),	/* log */
-        OP_INT2(PtCr_mod),	/* mod */
-        OP_NUM2(PtCr_mul_int, PtCr_mul),	/* mul */
-        OP_NUM1(PtCr_neg_int, PtCr_neg),	/* neg */
-        OP1(PtCr_not, PtCr_not, E),	/* not */
-        OP_INT_BOOL2(PtCr_or),  /* or */
-        OP_NUM1(N, PtCr_round),	/* round */
-        OP_MATH1(PtCr_sin),	/* sin */
-        OP_MATH1(PtCr_sqrt),	/* sqrt */
-        OP_NUM2(PtCr_sub_int, PtCr_sub),	/* sub */
-        OP_NUM1(N, PtCr_truncate),	/* truncate */
-        OP_INT_BOOL2(PtCr_xor),  /* xor */
-
-    /* Comparison operators */
-
-        OP_REL2(PtCr_eq_int, PtCr_eq),	/* eq */
-        OP_NUM2(PtCr_ge_int, PtCr_ge),	/* ge */
-        OP_NUM2(PtCr_gt_int, PtCr_gt),	/* gt */
-        OP_NUM2(PtCr_le_int, PtCr_le),	/* le */
-        OP_NUM2(PtCr_lt_int, PtCr_lt),	/* lt */
-        OP_REL2(PtCr_ne_int, PtCr_ne),	/* ne */
-
-    /* Stack operators */
-
-        OP1(E, PtCr_copy, E),	/* copy */
-        OP_ANY1(PtCr_dup),	/* dup */
-        OP_ANY2(PtCr_exch),	/* exch */
-        OP1(E, PtCr_index, E),	/* index */
-        OP_ANY1(PtCr_pop),	/* pop */
-        OP_INT2(PtCr_roll),	/* roll */
-
-    /* Constants */
-
-        OP_NONE(PtCr_byte),		/* byte */
-        OP_NONE(PtCr_int),		/* int */
-        OP_NONE(PtCr_float),		/* float */
-        OP_NONE(PtCr_true),		/* true */
-        OP_NONE(PtCr_false),		/* false */
-
-    /* Special */
-
-        OP1(PtCr_if, E, E),		/* if */
-        OP_NONE(PtCr_else),		/* else */
-        OP_NONE(PtCr_return),		/* return */
-        OP1(E, PtCr_repeat, E),		/* repeat */
-        OP_NONE(PtCr_repeat_end)	/* repeat_end */
-    };
+/* Arithmetic operators */
+
+    OP_NUM1(PtCr_abs_int, PtCr_abs),	/* abs */
+    OP_NUM2(PtCr_add_int, PtCr_add),	/* add */
+    OP_INT_BOOL2(PtCr_and),  /* and */
+    OP_MATH2(PtCr_atan),	/* atan */
+    OP_INT2(PtCr_bitshift),	/* bitshift */
+    OP_NUM1(N, PtCr_ceiling),	/* ceiling */
+    OP_MATH1(PtCr_cos),	/* cos */
+    OP_NUM1(N, PtCr_cvi),	/* cvi */
+    OP_NUM1(PtCr_int_to_float, N),	/* cvr */
+    OP_MATH2(PtCr_div),	/* div */
+    OP_MATH2(PtCr_exp),	/* exp */
+    OP_NUM1(N, PtCr_floor),	/* floor */
+    OP_INT2(PtCr_idiv),	/* idiv */
+    OP_MATH1(PtCr_ln),	/* ln */
+    OP_MATH1(PtCr_log),	/* log */
+    OP_INT2(PtCr_mod),	/* mod */
+    OP_NUM2(PtCr_mul_int, PtCr_mul),	/* mul */
+    OP_NUM1(PtCr_neg_int, PtCr_neg),	/* neg */
+    OP1(PtCr_not, PtCr_not, E),	/* not */
+    OP_INT_BOOL2(PtCr_or),  /* or */
+    OP_NUM1(N, PtCr_round),	/* round */
+    OP_MATH1(PtCr_sin),	/* sin */
+    OP_MATH1(PtCr_sqrt),	/* sqrt */
+    OP_NUM2(PtCr_sub_int, PtCr_sub),	/* sub */
+    OP_NUM1(N, PtCr_truncate),	/* truncate */
+    OP_INT_BOOL2(PtCr_xor),  /* xor */
+
+/* Comparison operators */
+
+    OP_REL2(PtCr_eq_int, PtCr_eq),	/* eq */
+    OP_NUM2(PtCr_ge_int, PtCr_ge),	/* ge */
+    OP_NUM2(PtCr_gt_int, PtCr_gt),	/* gt */
+    OP_NUM2(PtCr_le_int, PtCr_le),	/* le */
+    OP_NUM2(PtCr_lt_int, PtCr_lt),	/* lt */
+    OP_REL2(PtCr_ne_int, PtCr_ne),	/* ne */
+
+/* Stack operators */
+
+    OP1(E, PtCr_copy, E),	/* copy */
+    OP_ANY1(PtCr_dup),	/* dup */
+    OP_ANY2(PtCr_exch),	/* exch */
+    OP1(E, PtCr_index, E),	/* index */
+    OP_ANY1(PtCr_pop),	/* pop */
+    OP_INT2(PtCr_roll),	/* roll */
+
+/* Constants */
+
+    OP_NONE(PtCr_byte),		/* byte */
+    OP_NONE(PtCr_int),		/* int */
+    OP_NONE(PtCr_float),		/* float */
+    OP_NONE(PtCr_true),		/* true */
+    OP_NONE(PtCr_false),		/* false */
+
+/* Special */
+
+    OP1(PtCr_if, E, E),		/* if */
+    OP_NONE(PtCr_else),		/* else */
+    OP_NONE(PtCr_return),		/* return */
+    OP1(E, PtCr_repeat, E),		/* repeat */
+    OP_NONE(PtCr_repeat_end)	/* repeat_end */
+};
+
+/*
+ * Execute compiled operations.  The types of the operands are known,
+ * and the stack depth has been checked by fn_PtCr_compile.
+ * Return 1 if the interpreter must be used instead.
+ */
+static int
+calc_execute_compiled(const calc_compiled_op_t *op, const calc_compiled_op_t *end,
+                      calc_value_t **pvsp)
+{
+    calc_value_t *vsp = *pvsp;
+    calc_value_t t;
+    int i, n;
+
+    for (; op < end; ++op)
+        switch (op->op) {
+        case PtCr_push:
+            *++vsp = op->value;
+            continue;
+
+            /* Coerce */
+
+        case PtCr_int_to_float:
+            store_float(vsp, (floatp)vsp->value.i);
+            continue;
+        case PtCr_int2_to_float:
+            store_float(vsp, (floatp)vsp->value.i);
+        case PtCr_2nd_int_to_float:
+            store_float(vsp - 1, (floatp)vsp[-1].value.i);
+            continue;
+
+            /* Arithmetic operators */
+
+        case PtCr_abs_int:
+            if (vsp->value.i >= 0)
+                continue;
+        case PtCr_neg_int:
+            if (vsp->value.i == min_int)
+                return 1;
+            vsp->value.i = -vsp->value.i;
+            continue;
+        case PtCr_abs:
+            vsp->value.f = fabs(vsp->value.f);
+            continue;
+        case PtCr_add_int: {
+            int int1 = vsp[-1].value.i, int2 = vsp->value.i;
+
+            if ((int1 ^ int2) >= 0 && ((int1 + int2) ^ int1) < 0)
+                return 1;
+            vsp[-1].value.i = int1 + int2;
+            --vsp; continue;
+        }
+        case PtCr_add:
+            vsp[-1].value.f += vsp->value.f;
+            --vsp; continue;
+        case PtCr_and:
+            vsp[-1].value.i &= vsp->value.i;
+            --vsp; continue;
+        case PtCr_atan: {
+            double result;
+
+            if (gs_atan2_degrees(vsp[-1].value.f, vsp->value.f, &result) < 0)
+                return 1;
+            vsp[-1].value.f = result;
+            --vsp; continue;
+        }
+        case PtCr_bitshift:
+#define MAX_SHIFT (ARCH_SIZEOF_INT * 8 - 1)
+            if (vsp->value.i < -MAX_SHIFT || vsp->value.i > MAX_SHIFT)
+                vsp[-1].value.i = 0;
+#undef MAX_SHIFT
+            else if ((n = vsp->value.i) < 0)
+                vsp[-1].value.i = ((uint)(vsp[-1].value.i)) >> -n;
+            else
+                vsp[-1].value.i <<= n;
+            --vsp; continue;
+        case PtCr_ceiling:
+            vsp->value.f = ceil(vsp->value.f);
+            continue;
+        case PtCr_cos:
+            vsp->value.f = gs_cos_degrees(vsp->value.f);
+            continue;
+        case PtCr_cvi:
+            vsp->value.i = (int)(vsp->value.f);
+            vsp->type = CVT_INT;
+            continue;
+        case PtCr_cvr:
+            continue;
+        case PtCr_div:
+            if (vsp->value.f == 0)
+                return 1;
+            vsp[-1].value.f /= vsp->value.f;
+            --vsp; continue;
+        case PtCr_exp:
+            vsp[-1].value.f = pow(vsp[-1].value.f, vsp->value.f);
+            --vsp; continue;
+        case PtCr_floor:
+            vsp->value.f = floor(vsp->value.f);
+            continue;
+        case PtCr_idiv:
+            if (vsp->value.i == 0 ||
+                (vsp[-1].value.i == min_int && vsp->value.i == -1))
+                return 1;
+            vsp[-1].value.i /= vsp->value.i;
+            --vsp; continue;
+        case PtCr_ln:
+            vsp->value.f = log(vsp->value.f);
+            continue;
+        case PtCr_log:
+            vsp->value.f = log10(vsp->value.f);
+            continue;
+        case PtCr_mod:
+            if (vsp->value.i == 0)
+                return 1;
+            vsp[-1].value.i %= vsp->value.i;
+            --vsp; continue;
+        case PtCr_mul_int: {
+            double prod = (double)vsp[-1].value.i * vsp->value.i;
+
+            if (prod < min_int || prod > max_int)
+                return 1;
+            vsp[-1].value.i = (int)prod;
+            --vsp; continue;
+        }
+        case PtCr_mul:
+            vsp[-1].value.f *= vsp->value.f;
+            --vsp; continue;
+        case PtCr_neg:
+            vsp->value.f = -vsp->value.f;
+            continue;
+        case PtCr_not:
+            vsp->value.i = ~vsp->value.i;
+            continue;
+        case PtCr_or:
+            vsp[-1].value.i |= vsp->value.i;
+            --vsp; continue;
+        case PtCr_round:
+            vsp->value.f = floor(vsp->value.f + 0.5);
+            continue;
+        case PtCr_sin:
+            vsp->value.f = gs_sin_degrees(vsp->value.f);
+            continue;
+        case PtCr_sqrt:
+            vsp->value.f = sqrt(vsp->value.f);
+            continue;
+        case PtCr_sub_int: {
+            int int1 = vsp[-1].value.i, int2 = vsp->value.i;
+
+            if ((int1 ^ int2) < 0 && ((int1 - int2) ^ int1) >= 0)
+                return 1;
+            vsp[-1].value.i = int1 - int2;
+            --vsp; continue;
+        }
+        case PtCr_sub:
+            vsp[-1].value.f -= vsp->value.f;
+            --vsp; continue;
+        case PtCr_truncate:
+            vsp->value.f = (vsp->value.f < 0 ? ceil(vsp->value.f) :
+                            floor(vsp->value.f));
+            continue;
+        case PtCr_xor:
+            vsp[-1].value.i ^= vsp->value.i;
+            --vsp; continue;
+
+            /* Boolean operators */
+
+#define DO_REL(rel, m)\
+  vsp[-1].value.i = vsp[-1].value.m rel vsp->value.m;\
+  vsp[-1].type = CVT_BOOL;\
+  --vsp; continue
+
+        case PtCr_eq_int:
+            DO_REL(==, i);
+        case PtCr_eq:
+            DO_REL(==, f);
+        case PtCr_ge_int:
+            DO_REL(>=, i);
+        case PtCr_ge:
+            DO_REL(>=, f);
+        case PtCr_gt_int:
+            DO_REL(>, i);
+        case PtCr_gt:
+            DO_REL(>, f);
+        case PtCr_le_int:
+            DO_REL(<=, i);
+        case PtCr_le:
+            DO_REL(<=, f);
+        case PtCr_lt_int:
+            DO_REL(<, i);
+        case PtCr_lt:
+            DO_REL(<, f);
+        case PtCr_ne_int:
+            DO_REL(!=, i);
+        case PtCr_ne:
+            DO_REL(!=, f);
+
+#undef DO_REL
+
+            /* Stack operators */
+
+        case PtCr_copy:
+            i = vsp->value.i;
+            memcpy(vsp, vsp - i, i * sizeof(*vsp));
+            vsp += i - 1;
+            continue;
+        case PtCr_dup:
+            vsp[1] = *vsp;
+            ++vsp;
+            continue;
+        case PtCr_exch:
+            t = *vsp;
+            *vsp = vsp[-1];
+            vsp[-1] = t;
+            continue;
+        case PtCr_index:
+            i = vsp->value.i;
+            *vsp = vsp[-i - 1];
+            continue;
+        case PtCr_pop:
+            --vsp;
+            continue;
+        case PtCr_roll:
+            n = vsp[-1].value.i;
+            i = vsp->value.i;
+            for (; i > 0; i--) {
+                memmove(vsp - n, vsp - (n + 1), n * sizeof(*vsp));
+                vsp[-(n + 1)] = vsp[-1];
+            }
+            for (; i < 0; i++) {
+                vsp[-1] = vsp[-(n + 1)];
+                memmove(vsp - (n + 1), vsp - n, n * sizeof(*vsp));
+            }
+            vsp -= 2;
+            continue;
+        default:
+            return 1;
+        }
+    *pvsp = vsp;
+    return 0;
+}
+
+/*
+ * Append a typed operation to the compiled code, maintaining the types
+ * of the stack slots.  nconst is the number of the trailing PtCr_push
+ * operations, which supply the topmost stack values; when all operands
+ * of an operation are among them, the operation is executed right now.
+ * Return < 0 if the operation can't be compiled.
+ */
+static int
+calc_compile_op(calc_compiled_op_t *code, int *pcount, int max_count, int op,
+                calc_value_type_t *types, int *pdepth, int *pnconst)
+{
+    int count = *pcount, depth = *pdepth, nconst = *pnconst;
+    calc_value_type_t t0 = types[depth], t1 = types[depth - 1];
+    int i, n, nargs;
+
+    switch (op) {
+    case PtCr_int_to_float:
+        types[depth] = CVT_FLOAT;
+        nargs = 1; break;
+    case PtCr_2nd_int_to_float:
+        types[depth - 1] = CVT_FLOAT;
+        nargs = 2; break;
+    case PtCr_int2_to_float:
+        types[depth] = types[depth - 1] = CVT_FLOAT;
+        nargs = 2; break;
+    case PtCr_abs_int: case PtCr_neg_int: case PtCr_cvi:
+        types[depth] = CVT_INT;
+        nargs = 1; break;
+    case PtCr_abs: case PtCr_ceiling: case PtCr_cos: case PtCr_cvr:
+    case PtCr_floor: case PtCr_ln: case PtCr_log: case PtCr_neg:
+    case PtCr_round: case PtCr_sin: case PtCr_sqrt: case PtCr_truncate:
+        types[depth] = CVT_FLOAT;
+        nargs = 1; break;
+    case PtCr_not:
+        nargs = 1; break;
+    case PtCr_add_int: case PtCr_sub_int: case PtCr_mul_int:
+    case PtCr_bitshift: case PtCr_idiv: case PtCr_mod:
+        types[--depth] = CVT_INT;
+        nargs = 2; break;
+    case PtCr_add: case PtCr_sub: case PtCr_mul:
+    case PtCr_div: case PtCr_atan: case PtCr_exp:
+        types[--depth] = CVT_FLOAT;
+        nargs = 2; break;
+    case PtCr_and: case PtCr_or: case PtCr_xor:
+        types[--depth] = t0;
+        nargs = 2; break;
+    case PtCr_eq_int: case PtCr_eq: case PtCr_ge_int: case PtCr_ge:
+    case PtCr_gt_int: case PtCr_gt: case PtCr_le_int: case PtCr_le:
+    case PtCr_lt_int: case PtCr_lt: case PtCr_ne_int: case PtCr_ne:
+        types[--depth] = CVT_BOOL;
+        nargs = 2; break;
+    case PtCr_dup:
+        if (depth == MAX_VSTACK)
+            return -1;
+        types[++depth] = t0;
+        nargs = 1; break;
+    case PtCr_exch:
+        types[depth] = t1;
+        types[depth - 1] = t0;
+        nargs = 2; break;
+    case PtCr_pop:
+        --depth;
+        nargs = 1; break;
+        /* The operands of copy, index and roll must be constants. */
+    case PtCr_copy:
+        if (nconst < 1)
+            return -1;
+        i = code[count - 1].value.value.i;
+        if (i < 0 || i >= depth || i > MAX_VSTACK - (depth - 1))
+            return -1;
+        memcpy(&types[depth], &types[depth - i], i * sizeof(*types));
+        depth += i - 1;
+        nargs = 0; break;
+    case PtCr_index:
+        if (nconst < 1)
+            return -1;
+        i = code[count - 1].value.value.i;
+        if (i < 0 || i >= depth - 1)
+            return -1;
+        types[depth] = types[depth - i - 1];
+        nargs = 0; break;
+    case PtCr_roll:
+        if (nconst < 2)
+            return -1;
+        n = code[count - 2].value.value.i;
+        i = code[count - 1].value.value.i;
+        if (n < 0 || n > depth - 2)
+            return -1;
+        for (; i > 0; i--) {
+            memmove(&types[depth - n], &types[depth - (n + 1)], n * sizeof(*types));
+            types[depth - (n + 1)] = types[depth - 1];
+        }
+        for (; i < 0; i++) {
+            types[depth - 1] = types[depth - (n + 1)];
+            memmove(&types[depth - (n + 1)], &types[depth - n], n * sizeof(*types));
+        }
+        depth -= 2;
+        nargs = 0; break;
+    default:
+        return -1;
+    }
+    if (nargs > 0 && nconst >= nargs) {
+        /* Fold the operation with constant operands. */
+        calc_value_t vals[4], *vsp = vals;
+        calc_compiled_op_t cop;
+
+        for (i = count - nargs; i < count; i++)
+            *++vsp = code[i].value;
+        cop.op = op;
+        if (calc_execute_compiled(&cop, &cop + 1, &vsp) == 0) {
+            n = vsp - vals;
+            count -= nargs;
+            if (count + n > max_count)
+                return -1;
+            for (i = 1; i <= n; i++) {
+                code[count].op = PtCr_push;
+                code[count++].value = vals[i];
+            }
+            *pcount = count;
+            *pdepth = depth;
+            *pnconst = nconst - nargs + n;
+            return 0;
+        }
+    }
+    if (count == max_count)
+        return -1;
+    code[count].op = op;
+    *pcount = count + 1;
+    *pdepth = depth;
+    *pnconst = 0;
+    return 0;
+}
+
+/*
+ * Compile a PostScript Calculator function if possible.  Each operator
+ * compiles to at most a coercion and the operation itself, and each takes
+ * at least one byte of the program, so twice the program size bounds the
+ * code; the buffer is trimmed to the actual size afterwards.
+ */
+static void
+fn_PtCr_compile(gs_function_PtCr_t *pfn, gs_memory_t *mem)
+{
+    const byte *p = pfn->params.ops.data;
+    calc_value_type_t types_buf[2 + MAX_VSTACK + 1];
+    calc_value_type_t *types = &types_buf[1];
+    int depth = pfn->params.m, nconst = 0;
+    int max_count = 2 * pfn->params.ops.size;
+    calc_compiled_op_t *code;
+    int count = 0;
+    int i;
+
+    pfn->compiled_count = -1;
+    pfn->compiled = 0;
+    code = (calc_compiled_op_t *)
+        gs_alloc_byte_array(mem, max_count, sizeof(calc_compiled_op_t),
+                            "fn_PtCr_compile");
+    if (code == 0)
+        return;			/* just interpret the program */
+    types[-1] = types[0] = CVT_NONE;
+    for (i = 1; i <= depth; ++i)
+        types[i] = CVT_FLOAT;
+    while (*p != PtCr_return) {
+        int op = *p++;
+        calc_value_t v;
+
+        switch (op) {
+        case PtCr_byte:
+            v.value.i = *p++, v.type = CVT_INT;
+            break;
+        case PtCr_int:
+            memcpy(&v.value.i, p, sizeof(int));
+            v.type = CVT_INT;
+            p += sizeof(int);
+            break;
+        case PtCr_float:
+            memcpy(&v.value.f, p, sizeof(float));
+            v.type = CVT_FLOAT;
+            p += sizeof(float);
+            break;
+        case PtCr_true:
+            v.value.i = true, v.type = CVT_BOOL;
+            break;
+        case PtCr_false:
+            v.value.i = false, v.type = CVT_BOOL;
+            break;
+        case PtCr_if:
+        case PtCr_else:
+        case PtCr_repeat:
+        case PtCr_repeat_end:
+            goto fail;
+        default:
+            for (;;) {
+                int top = (types[depth - 1] << 2) + types[depth];
+                int typed_op = op_defn_table[op].opcode[top];
+
+                if (typed_op == PtCr_no_op)
+                    break;
+                if (typed_op == PtCr_typecheck)
+                    goto fail;
+                if (calc_compile_op(code, &count, max_count, typed_op, types,
+                                    &depth, &nconst) < 0)
+                    goto fail;
+                if (typed_op != PtCr_int_to_float &&
+                    typed_op != PtCr_2nd_int_to_float &&
+                    typed_op != PtCr_int2_to_float)
+                    break;
+                /* Re-dispatch with the coerced operands. */
+            }
+            continue;
+        }
+        if (depth == MAX_VSTACK || count == max_count)
+            goto fail;
+        code[count].op = PtCr_push;
+        code[count++].value = v;
+        types[++depth] = v.type;
+        ++nconst;
+    }
+    if (depth != pfn->params.n)
+        goto fail;
+    for (i = 1; i <= depth; ++i)
+        if (types[i] != CVT_INT && types[i] != CVT_FLOAT)
+            goto fail;
+    if (count < max_count) {
+        calc_compiled_op_t *trimmed = (calc_compiled_op_t *)
+            gs_resize_object(mem, code,
+                             max(count, 1) * sizeof(calc_compiled_op_t),
+                             "fn_PtCr_compile");
+
+        if (trimmed != 0)
+            code = trimmed;
+    }
+    pfn->compiled = code;
+    pfn->compiled_count = count;
+    return;
+ fail:
+    gs_free_object(mem, code, "fn_PtCr_compile");
+}
+
+/* Evaluate a PostScript Calculator function. */
+static int
+fn_PtCr_evaluate(const gs_function_t *pfn_common, const float *in, float *out)
+{
+    const gs_function_PtCr_t *pfn = (const gs_function_PtCr_t *)pfn_common;
+    calc_value_t vstack_buf[2 + MAX_VSTACK + 1];
+    calc_value_t *vstack = &vstack_buf[1];
+    calc_value_t *vsp = vstack + pfn->params.m;
+    const byte *p = pfn->params.ops.data;
+    int repeat_count[MAX_PSC_FUNCTION_NESTING];
+    int repeat_proc_size[MAX_PSC_FUNCTION_NESTING];
+    int repeat_nesting_level = -1;
+    int i;
 
     vstack[-1].type = CVT_NONE;  /* for type dispatch in empty stack case */
     vstack[0].type = CVT_NONE;	/* catch underflow */
     for (i = 0; i < pfn->params.m; ++i)
         store_float(&vstack[i + 1], in[i]);
+    if (pfn->compiled_count >= 0) {
+        calc_value_t *csp = vsp;
+
+        if (calc_execute_compiled(pfn->compiled,
+                                  pfn->compiled + pfn->compiled_count, &csp) == 0) {
+            vsp = csp;
+            goto fin;
+        }
+        /* Start over with the interpreter. */
+        for (i = 0; i < pfn->params.m; ++i)
+            store_float(&vstack[i + 1], in[i]);
+    }
 
     for (; ; ) {
         int code, n;
@@ -740,6 +1251,8 @@ fn_PtCr_make_scaled(const gs_function_PtCr_t *pfn, gs_function_PtCr_t **ppsfn,
         return_error(gs_error_VMerror);
     }
     psfn->params = pfn->params;
+    psfn->compiled = 0;
+    psfn->compiled_count = -1;
     psfn->params.ops.data = ops;
     psfn->params.ops.size = opsize;
     psfn->data_source = pfn->data_source;
@@ -777,6 +1290,7 @@ fn_PtCr_make_scaled(const gs_function_PtCr_t *pfn, gs_function_PtCr_t **ppsfn,
     psfn->params.ops.data =
         gs_resize_string(mem, ops, opsize, psfn->params.ops.size,
                          "fn_PtCr_make_scaled");
+    fn_PtCr_compile(psfn, mem);
     *ppsfn = psfn;
     return 0;
 }
@@ -789,6 +1303,16 @@ gs_function_PtCr_free_params(gs_function_PtCr_params_t * params, gs_memory_t * m
     fn_common_free_params((gs_function_params_t *) params, mem);
 }
 
+/* Free a PostScript Calculator function and its compiled code. */
+static void
+fn_PtCr_free(gs_function_t * pfn_common, bool free_params, gs_memory_t * mem)
+{
+    gs_function_PtCr_t *const pfn = (gs_function_PtCr_t *)pfn_common;
+
+    gs_free_object(mem, pfn->compiled, "fn_PtCr_free");
+    fn_common_free(pfn_common, free_params, mem);
+}
+
 /* Serialize. */
 static int
 gs_function_PtCr_serialize(const gs_function_t * pfn, stream *s)
@@ -819,7 +1343,7 @@ gs_function_PtCr_init(gs_function_t ** ppfn,
             fn_common_get_params,
             (fn_make_scaled_proc_t) fn_PtCr_make_scaled,
             (fn_free_params_proc_t) gs_function_PtCr_free_params,
-            fn_common_free,
+            fn_PtCr_free,
             (fn_serialize_proc_t) gs_function_PtCr_serialize,
         }
     };
@@ -877,6 +1401,7 @@ gs_function_PtCr_init(gs_function_t ** ppfn,
         data_source_init_string2(&pfn->data_source, NULL, 0);
         pfn->data_source.access = calc_access;
         pfn->head = function_PtCr_head;
+        fn_PtCr_compile(pfn, mem);
         *ppfn = (gs_function_t *) pfn;
     }
     return 0;
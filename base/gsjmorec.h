@@ -34,7 +34,10 @@
  */
 
 #undef BLOCK_SMOOTHING_SUPPORTED
-#undef IDCT_SCALING_SUPPORTED
+/*
+ * Keep IDCT_SCALING_SUPPORTED: DCTDecode uses it to decode images at
+ * 1/2, 1/4 or 1/8 size when they will be scaled down for the device.
+ */
 #undef UPSAMPLE_SCALING_SUPPORTED
 #undef UPSAMPLE_MERGING_SUPPORTED
 #undef QUANT_1PASS_SUPPORTED
@@ -415,6 +415,23 @@ extern const gs_memory_procs_t gs_ref_memory_procs;
                 }\
         }
 
+/*
+ * Walk the allocated objects in the chunks of an allocator state for VM
+ * statistics, calling proc (if not 0) with the type and size of each one,
+ * and add the chunk usage to *pcs.
+ */
+typedef struct gs_chunk_stats_s {
+    ulong chunks;		/* # of chunks, including inner ones */
+    ulong free_gaps;		/* unallocated space between cbot and ctop */
+    ulong free_objects;		/* space in freed (st_free) objects */
+    ulong strings;		/* space between ctop and climit */
+} gs_chunk_stats_t;
+typedef void (*ialloc_enum_stats_proc_t)(void *client,
+                                         gs_memory_type_ptr_t pstype,
+                                         uint size);
+void ialloc_enum_stats(gs_ref_memory_t *mem, ialloc_enum_stats_proc_t proc,
+                       void *client, gs_chunk_stats_t *pcs);
+
 /* ================ Debugging ================ */
 
 #ifdef DEBUG
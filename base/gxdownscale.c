@@ -17,6 +17,7 @@
 #include "gxdownscale.h"
 #include "gserrors.h"
 #include "gdevprn.h"
+#include "gdebug.h"
 
 /* Error diffusion data is stored in errors block.
  * We have 1 empty entry at each end to avoid overflow. When
@@ -44,22 +45,40 @@ static void pack_8to1(byte *outp, byte *inp, int w)
 {
     int mask  = 128;
     int value = 0;
+
+    /* Whole bytes first; the values are known to be 0 or 1. */
+    for (; w >= 8; w -= 8)
+    {
+        *outp++ = (inp[0]<<7) | (inp[1]<<6) | (inp[2]<<5) | (inp[3]<<4) |
+                  (inp[4]<<3) | (inp[5]<<2) | (inp[6]<<1) |  inp[7];
+        inp += 8;
+    }
     for (; w > 0; w--)
     {
         if (*inp++)
             value |= mask;
         mask >>= 1;
-        if (mask == 0) {
-            mask = 128;
-            *outp++= value;
-            value = 0;
-        }
     }
     if (mask != 128) {
         *outp++ = value;
     }
 }
 
+/* Sum a factor x factor block of 8 bit samples, row by row, so that
+ * the inner loop runs over adjacent bytes. */
+static inline int box_sum8(const byte *inp, int factor, int span)
+{
+    int x, y, value = 0;
+
+    for (y = factor; y > 0; y--)
+    {
+        for (x = 0; x < factor; x++)
+            value += inp[x];
+        inp += span;
+    }
+    return value;
+}
+
 static void down_core(gx_downscaler_t *ds,
                       byte            *out_buffer,
                       byte            *in_buffer,
@@ -67,7 +86,7 @@ static void down_core(gx_downscaler_t *ds,
                       int              plane,
                       int              span)
 {
-    int        x, xx, y, value;
+    int        x, y, value;
     int        e_downleft, e_down, e_forward = 0;
     int        pad_white;
     byte      *inp, *outp;
@@ -96,21 +115,12 @@ static void down_core(gx_downscaler_t *ds,
     if ((row & 1) == 0)
     {
         /* Left to Right pass (no min feature size) */
-        const int back = span * factor - 1;
         errors += 2;
         outp = inp;
         for (x = awidth; x > 0; x--)
         {
-            value = e_forward + *errors;
-            for (xx = factor; xx > 0; xx--)
-            {
-                for (y = factor; y > 0; y--)
-                {
-                    value += *inp;
-                    inp += span;
-                }
-                inp -= back;
-            }
+            value = e_forward + *errors + box_sum8(inp, factor, span);
+            inp += factor;
             if (value >= threshold)
             {
                 *outp++ = 1;
@@ -133,22 +143,13 @@ static void down_core(gx_downscaler_t *ds,
     else
     {
         /* Right to Left pass (no min feature size) */
-        const int back = span * factor + 1;
         errors += awidth;
         inp += awidth*factor-1;
         outp = inp;
         for (x = awidth; x > 0; x--)
         {
-            value = e_forward + *errors;
-            for (xx = factor; xx > 0; xx--)
-            {
-                for (y = factor; y > 0; y--)
-                {
-                    value += *inp;
-                    inp += span;
-                }
-                inp -= back;
-            }
+            value = e_forward + *errors + box_sum8(inp - factor + 1, factor, span);
+            inp -= factor;
             if (value >= threshold)
             {
                 *outp-- = 1;
@@ -553,7 +554,7 @@ static void down_core_mfs(gx_downscaler_t *ds,
                           int              plane,
                           int              span)
 {
-    int        x, xx, y, value;
+    int        x, y, value;
     int        e_downleft, e_down, e_forward = 0;
     int        pad_white;
     byte      *inp, *outp;
@@ -583,23 +584,14 @@ static void down_core_mfs(gx_downscaler_t *ds,
     if ((row & 1) == 0)
     {
         /* Left to Right pass (with min feature size = 2) */
-        const int back = span * factor -1;
         byte mfs, force_forward = 0;
         errors += 2;
         outp = inp;
         *mfs_data++ = mfs_clear;
         for (x = awidth; x > 0; x--)
         {
-            value = e_forward + *errors;
-            for (xx = factor; xx > 0; xx--)
-            {
-                for (y = factor; y > 0; y--)
-                {
-                    value += *inp;
-                    inp += span;
-                }
-                inp -= back;
-            }
+            value = e_forward + *errors + box_sum8(inp, factor, span);
+            inp += factor;
             mfs = *mfs_data;
             *mfs_data++ = mfs_clear;
             if ((mfs & mfs_force_off) || force_forward)
@@ -647,7 +639,6 @@ static void down_core_mfs(gx_downscaler_t *ds,
     else
     {
         /* Right to Left pass (with min feature size = 2) */
-        const int back = span * factor + 1;
         byte mfs, force_forward = 0;
         errors += awidth;
         mfs_data += awidth;
@@ -656,16 +647,8 @@ static void down_core_mfs(gx_downscaler_t *ds,
         *mfs_data-- = 0;
         for (x = awidth; x > 0; x--)
         {
-            value = e_forward + *errors;
-            for (xx = factor; xx > 0; xx--)
-            {
-                for (y = factor; y > 0; y--)
-                {
-                    value += *inp;
-                    inp += span;
-                }
-                inp -= back;
-            }
+            value = e_forward + *errors + box_sum8(inp - factor + 1, factor, span);
+            inp -= factor;
             mfs = *mfs_data;
             *mfs_data-- = mfs_clear;
             if ((mfs & mfs_force_off) || force_forward)
@@ -774,7 +757,7 @@ static void down_core8(gx_downscaler_t *ds,
                        int              plane,
                        int              span)
 {
-    int   x, xx, y, value;
+    int   x, y, value;
     int   pad_white;
     byte *inp;
     int   width  = ds->width;
@@ -799,19 +782,10 @@ static void down_core8(gx_downscaler_t *ds,
     inp = in_buffer;
     {
         /* Left to Right pass (no min feature size) */
-        const int back = span * factor -1;
         for (x = awidth; x > 0; x--)
         {
-            value = 0;
-            for (xx = factor; xx > 0; xx--)
-            {
-                for (y = factor; y > 0; y--)
-                {
-                    value += *inp;
-                    inp += span;
-                }
-                inp -= back;
-            }
+            value = box_sum8(inp, factor, span);
+            inp += factor;
             *outp++ = (value+(div>>1))/div;
         }
     }
@@ -1056,6 +1030,419 @@ static void down_core24(gx_downscaler_t *ds,
                         int              row,
                         int              plane,
                         int              span)
+{
+    int   x, xx, y;
+    int   pad_white;
+    byte *inp;
+    int   width  = ds->width;
+    int   awidth = ds->awidth;
+    int   factor = ds->factor;
+    int   div    = factor*factor;
+
+    pad_white = (awidth - width) * factor * 3;
+    if (pad_white < 0)
+        pad_white = 0;
+
+    if (pad_white)
+    {
+        inp = in_buffer + width*factor*3;
+        for (y = factor; y > 0; y--)
+        {
+            memset(inp, 0xFF, pad_white);
+            inp += span;
+        }
+    }
+
+    inp = in_buffer;
+    {
+        /* Left to Right pass (no min feature size) */
+        for (x = awidth; x > 0; x--)
+        {
+            /* Accumulate R, G and B together, one source row at a time */
+            const byte *row_p = inp;
+            int r = 0, g = 0, b = 0;
+
+            for (y = factor; y > 0; y--)
+            {
+                const byte *p = row_p;
+
+                for (xx = factor; xx > 0; xx--)
+                {
+                    r += p[0];
+                    g += p[1];
+                    b += p[2];
+                    p += 3;
+                }
+                row_p += span;
+            }
+            inp += factor * 3;
+            *outp++ = (r+(div>>1))/div;
+            *outp++ = (g+(div>>1))/div;
+            *outp++ = (b+(div>>1))/div;
+        }
+    }
+}
+
+#ifdef DEBUG
+/*
+ * The generic cores as they were before they summed each block a row at
+ * a time, kept as a reference for the current ones: see
+ * down_core_compare below.
+ */
+
+static void pack_8to1_ref(byte *outp, byte *inp, int w)
+{
+    int mask  = 128;
+    int value = 0;
+    for (; w > 0; w--)
+    {
+        if (*inp++)
+            value |= mask;
+        mask >>= 1;
+        if (mask == 0) {
+            mask = 128;
+            *outp++= value;
+            value = 0;
+        }
+    }
+    if (mask != 128) {
+        *outp++ = value;
+    }
+}
+
+static void down_core_ref(gx_downscaler_t *ds,
+                          byte            *out_buffer,
+                          byte            *in_buffer,
+                          int              row,
+                          int              plane,
+                          int              span)
+{
+    int        x, xx, y, value;
+    int        e_downleft, e_down, e_forward = 0;
+    int        pad_white;
+    byte      *inp, *outp;
+    int        width     = ds->width;
+    int        awidth    = ds->awidth;
+    int        factor    = ds->factor;
+    int       *errors    = ds->errors + (awidth+3)*plane;
+    const int  threshold = factor*factor*128;
+    const int  max_value = factor*factor*255;
+
+    pad_white = (awidth - width) * factor;
+    if (pad_white < 0)
+        pad_white = 0;
+
+    if (pad_white)
+    {
+        inp = in_buffer + width*factor;
+        for (y = factor; y > 0; y--)
+        {
+            memset(inp, 0xFF, pad_white);
+            inp += span;
+        }
+    }
+
+    inp = in_buffer;
+    if ((row & 1) == 0)
+    {
+        /* Left to Right pass (no min feature size) */
+        const int back = span * factor - 1;
+        errors += 2;
+        outp = inp;
+        for (x = awidth; x > 0; x--)
+        {
+            value = e_forward + *errors;
+            for (xx = factor; xx > 0; xx--)
+            {
+                for (y = factor; y > 0; y--)
+                {
+                    value += *inp;
+                    inp += span;
+                }
+                inp -= back;
+            }
+            if (value >= threshold)
+            {
+                *outp++ = 1;
+                value -= max_value;
+            }
+            else
+            {
+                *outp++ = 0;
+            }
+            e_forward  = value * 7/16;
+            e_downleft = value * 3/16;
+            e_down     = value * 5/16;
+            value     -= e_forward + e_downleft + e_down;
+            errors[-2] += e_downleft;
+            errors[-1] += e_down;
+            *errors++   = value;
+        }
+        outp -= awidth;
+    }
+    else
+    {
+        /* Right to Left pass (no min feature size) */
+        const int back = span * factor + 1;
+        errors += awidth;
+        inp += awidth*factor-1;
+        outp = inp;
+        for (x = awidth; x > 0; x--)
+        {
+            value = e_forward + *errors;
+            for (xx = factor; xx > 0; xx--)
+            {
+                for (y = factor; y > 0; y--)
+                {
+                    value += *inp;
+                    inp += span;
+                }
+                inp -= back;
+            }
+            if (value >= threshold)
+            {
+                *outp-- = 1;
+                value -= max_value;
+            }
+            else
+            {
+                *outp-- = 0;
+            }
+            e_forward  = value * 7/16;
+            e_downleft = value * 3/16;
+            e_down     = value * 5/16;
+            value     -= e_forward + e_downleft + e_down;
+            errors[2] += e_downleft;
+            errors[1] += e_down;
+            *errors--   = value;
+        }
+        outp++;
+    }
+    pack_8to1_ref(out_buffer, outp, awidth);
+}
+
+static void down_core_mfs_ref(gx_downscaler_t *ds,
+                              byte            *out_buffer,
+                              byte            *in_buffer,
+                              int              row,
+                              int              plane,
+                              int              span)
+{
+    int        x, xx, y, value;
+    int        e_downleft, e_down, e_forward = 0;
+    int        pad_white;
+    byte      *inp, *outp;
+    int        width     = ds->width;
+    int        awidth    = ds->awidth;
+    int        factor    = ds->factor;
+    int       *errors    = ds->errors + (awidth+3)*plane;
+    byte      *mfs_data  = ds->mfs_data + (awidth+1)*plane;
+    const int  threshold = factor*factor*128;
+    const int  max_value = factor*factor*255;
+
+    pad_white = (awidth - width) * factor;
+    if (pad_white < 0)
+        pad_white = 0;
+
+    if (pad_white)
+    {
+        inp = in_buffer + width*factor;
+        for (y = factor; y > 0; y--)
+        {
+            memset(inp, 0xFF, pad_white);
+            inp += span;
+        }
+    }
+
+    inp = in_buffer;
+    if ((row & 1) == 0)
+    {
+        /* Left to Right pass (with min feature size = 2) */
+        const int back = span * factor -1;
+        byte mfs, force_forward = 0;
+        errors += 2;
+        outp = inp;
+        *mfs_data++ = mfs_clear;
+        for (x = awidth; x > 0; x--)
+        {
+            value = e_forward + *errors;
+            for (xx = factor; xx > 0; xx--)
+            {
+                for (y = factor; y > 0; y--)
+                {
+                    value += *inp;
+                    inp += span;
+                }
+                inp -= back;
+            }
+            mfs = *mfs_data;
+            *mfs_data++ = mfs_clear;
+            if ((mfs & mfs_force_off) || force_forward)
+            {
+                /* We are being forced to be 0 */
+                *outp++ = 0;
+                force_forward = 0;
+            }
+            else if (value < threshold)
+            {
+                /* We want to be 0 anyway */
+                *outp++ = 0;
+                if ((mfs & (mfs_above_is_0 | mfs_above_left_is_0))
+                        != (mfs_above_is_0 | mfs_above_left_is_0))
+                {
+                    /* We aren't in a group anyway, so must force other
+                     * pixels. */
+                    mfs_data[-2] |= mfs_force_off;
+                    mfs_data[-1] |= mfs_force_off;
+                    force_forward = 1;
+                }
+                else
+                {
+                    /* No forcing, but we need to tell other pixels that
+                     * we were 0. */
+                    mfs_data[-2] |= mfs_above_is_0;
+                    mfs_data[-1] |= mfs_above_left_is_0;
+                }
+            }
+            else
+            {
+                *outp++ = 1;
+                value -= max_value;
+            }
+            e_forward  = value * 7/16;
+            e_downleft = value * 3/16;
+            e_down     = value * 5/16;
+            value     -= e_forward + e_downleft + e_down;
+            errors[-2] += e_downleft;
+            errors[-1] += e_down;
+            *errors++   = value;
+        }
+        outp -= awidth;
+    }
+    else
+    {
+        /* Right to Left pass (with min feature size = 2) */
+        const int back = span * factor + 1;
+        byte mfs, force_forward = 0;
+        errors += awidth;
+        mfs_data += awidth;
+        inp += awidth*factor-1;
+        outp = inp;
+        *mfs_data-- = 0;
+        for (x = awidth; x > 0; x--)
+        {
+            value = e_forward + *errors;
+            for (xx = factor; xx > 0; xx--)
+            {
+                for (y = factor; y > 0; y--)
+                {
+                    value += *inp;
+                    inp += span;
+                }
+                inp -= back;
+            }
+            mfs = *mfs_data;
+            *mfs_data-- = mfs_clear;
+            if ((mfs & mfs_force_off) || force_forward)
+            {
+                /* We are being forced to be 0 */
+                *outp-- = 0;
+                force_forward = 0;
+            }
+            else if (value < threshold)
+            {
+                *outp-- = 0;
+                if ((mfs & (mfs_above_is_0 | mfs_above_left_is_0))
+                        != (mfs_above_is_0 | mfs_above_left_is_0))
+                {
+                    /* We aren't in a group anyway, so must force other
+                     * pixels. */
+                    mfs_data[1] |= mfs_force_off;
+                    mfs_data[2] |= mfs_force_off;
+                    force_forward = 1;
+                }
+                else
+                {
+                    /* No forcing, but we need to tell other pixels that
+                     * we were 0. */
+                    mfs_data[1] |= mfs_above_is_0;
+                    mfs_data[2] |= mfs_above_left_is_0;
+                }
+            }
+            else
+            {
+                *outp-- = 1;
+                value -= max_value;
+            }
+            e_forward  = value * 7/16;
+            e_downleft = value * 3/16;
+            e_down     = value * 5/16;
+            value     -= e_forward + e_downleft + e_down;
+            errors[2] += e_downleft;
+            errors[1] += e_down;
+            *errors--   = value;
+        }
+        outp++;
+    }
+    pack_8to1_ref(out_buffer, outp, awidth);
+}
+
+static void down_core8_ref(gx_downscaler_t *ds,
+                           byte            *outp,
+                           byte            *in_buffer,
+                           int              row,
+                           int              plane,
+                           int              span)
+{
+    int   x, xx, y, value;
+    int   pad_white;
+    byte *inp;
+    int   width  = ds->width;
+    int   awidth = ds->awidth;
+    int   factor = ds->factor;
+    int   div    = factor*factor;
+
+    pad_white = (awidth - width) * factor;
+    if (pad_white < 0)
+        pad_white = 0;
+
+    if (pad_white)
+    {
+        inp = in_buffer + width*factor;
+        for (y = factor; y > 0; y--)
+        {
+            memset(inp, 0xFF, pad_white);
+            inp += span;
+        }
+    }
+
+    inp = in_buffer;
+    {
+        /* Left to Right pass (no min feature size) */
+        const int back = span * factor -1;
+        for (x = awidth; x > 0; x--)
+        {
+            value = 0;
+            for (xx = factor; xx > 0; xx--)
+            {
+                for (y = factor; y > 0; y--)
+                {
+                    value += *inp;
+                    inp += span;
+                }
+                inp -= back;
+            }
+            *outp++ = (value+(div>>1))/div;
+        }
+    }
+}
+
+static void down_core24_ref(gx_downscaler_t *ds,
+                            byte            *outp,
+                            byte            *in_buffer,
+                            int              row,
+                            int              plane,
+                            int              span)
 {
     int   x, xx, y, value;
     int   pad_white;
@@ -1129,6 +1516,101 @@ static void down_core24(gx_downscaler_t *ds,
     }
 }
 
+/*
+ * Run the reference and the current version of a core on the same input,
+ * and report any difference in the output, the error diffusion table or
+ * the min feature size data.  The current version's results are kept.
+ */
+static void
+down_core_compare(gx_downscaler_t   *ds,
+                  gx_downscale_core *core,
+                  gx_downscale_core *ref,
+                  const char        *name,
+                  int                out_size,
+                  byte              *out_buffer,
+                  byte              *in_buffer,
+                  int                row,
+                  int                plane,
+                  int                span)
+{
+    int   awidth      = ds->awidth;
+    int   in_size     = span * ds->factor;
+    int   errors_size = (ds->errors ? (awidth+3) * sizeof(int) : 0);
+    int   mfs_size    = (ds->mfs_data ? awidth+1 : 0);
+    byte *errors      = in_buffer;
+    byte *mfs_data    = in_buffer;
+    int   state_size  = in_size + errors_size + mfs_size;
+    byte *save, *result;
+
+    if (errors_size)
+        errors = (byte *)(ds->errors + (awidth+3)*plane);
+    if (mfs_size)
+        mfs_data = ds->mfs_data + (awidth+1)*plane;
+    save = gs_alloc_bytes(ds->dev->memory,
+                          state_size + out_size + errors_size + mfs_size,
+                          "down_core_compare");
+    if (save == NULL) {
+        (*core)(ds, out_buffer, in_buffer, row, plane, span);
+        return;
+    }
+    result = save + state_size;
+
+    memcpy(save, in_buffer, in_size);
+    memcpy(save + in_size, errors, errors_size);
+    memcpy(save + in_size + errors_size, mfs_data, mfs_size);
+    (*ref)(ds, out_buffer, in_buffer, row, plane, span);
+    memcpy(result, out_buffer, out_size);
+    memcpy(result + out_size, errors, errors_size);
+    memcpy(result + out_size + errors_size, mfs_data, mfs_size);
+
+    memcpy(in_buffer, save, in_size);
+    memcpy(errors, save + in_size, errors_size);
+    memcpy(mfs_data, save + in_size + errors_size, mfs_size);
+    (*core)(ds, out_buffer, in_buffer, row, plane, span);
+
+    if (memcmp(result, out_buffer, out_size))
+        dlprintf3("[=]%s: output differs from the reference, row %d plane %d\n",
+                  name, row, plane);
+    if (memcmp(result + out_size, errors, errors_size))
+        dlprintf3("[=]%s: errors differ from the reference, row %d plane %d\n",
+                  name, row, plane);
+    if (memcmp(result + out_size + errors_size, mfs_data, mfs_size))
+        dlprintf3("[=]%s: mfs data differs from the reference, row %d plane %d\n",
+                  name, row, plane);
+    gs_free_object(ds->dev->memory, save, "down_core_compare");
+}
+
+#define DOWN_CORE_CHECK(core, out_size)\
+static void core##_check(gx_downscaler_t *ds, byte *out_buffer,\
+                         byte *in_buffer, int row, int plane, int span)\
+{\
+    down_core_compare(ds, core, core##_ref, #core, out_size,\
+                      out_buffer, in_buffer, row, plane, span);\
+}
+DOWN_CORE_CHECK(down_core, (ds->awidth+7)>>3)
+DOWN_CORE_CHECK(down_core_mfs, (ds->awidth+7)>>3)
+DOWN_CORE_CHECK(down_core8, ds->awidth)
+DOWN_CORE_CHECK(down_core24, ds->awidth*3)
+#undef DOWN_CORE_CHECK
+
+/* With -Z=, check the cores that have a reference version. */
+static gx_downscale_core *
+down_core_checked(gx_downscale_core *core)
+{
+    if (!gs_debug_c('='))
+        return core;
+    if (core == &down_core)
+        return &down_core_check;
+    if (core == &down_core_mfs)
+        return &down_core_mfs_check;
+    if (core == &down_core8)
+        return &down_core8_check;
+    if (core == &down_core24)
+        return &down_core24_check;
+    return core;
+}
+#endif /* DEBUG */
+
 static void decode_factor(int factor, int *up, int *down)
 {
     if (factor == 32)
@@ -1236,6 +1718,9 @@ int gx_downscaler_init_planar(gx_downscaler_t      *ds,
         core = &down_core8_2;
     else
         core = &down_core8;
+#ifdef DEBUG
+    core = down_core_checked(core);
+#endif
     ds->down_core = core;
 
     if (mfs > 1) {
@@ -1354,6 +1839,9 @@ int gx_downscaler_init(gx_downscaler_t   *ds,
         code = gs_note_error(gs_error_rangecheck);
         goto cleanup;
     }
+#ifdef DEBUG
+    core = down_core_checked(core);
+#endif
     ds->down_core = core;
 
     if (core != NULL) {
@@ -31,6 +31,7 @@
 #include "gxpath.h"
 #include "gxshade.h"
 #include "gxdevcli.h"
+#include "gxdevsop.h"
 #include "gxshade4.h"
 #include "vdtrace.h"
 #include "gsicc_cache.h"
@@ -213,6 +214,108 @@ A_fill_region(A_fill_state_t * pfs, patch_fill_state_t *pfs1)
     return patch_fill(pfs1, curve, NULL, NULL);
 }
 
+/*
+ * When the axis of an axial shading is parallel to a device axis,
+ * the parameter is constant along each device column (or row).
+ * In this case we evaluate the color directly at pixel centers
+ * and paint each run of equal colors with a single rectangle,
+ * instead of decomposing the shading into patches.
+ * Returns 1 if the shading was painted, 0 if the case doesn't apply.
+ */
+static int
+A_fill_direct(const A_fill_state_t * pfs, patch_fill_state_t *pfs1,
+              const gs_fixed_rect *clip_rect)
+{
+    const gs_shading_A_t * const psh = pfs->psh;
+    gx_device *dev = pfs1->dev;
+    const gs_matrix *pmat = (const gs_matrix *)&pfs1->pis->ctm;
+    float d0 = psh->params.Domain[0], dd = psh->params.Domain[1] - d0;
+    double d2 = pfs->delta.x * pfs->delta.x + pfs->delta.y * pfs->delta.y;
+    int x0 = fixed2int(clip_rect->p.x), x1 = fixed2int_ceiling(clip_rect->q.x);
+    int y0 = fixed2int(clip_rect->p.y), y1 = fixed2int_ceiling(clip_rect->q.y);
+    double t00, tx, ty, dt, t, tprev = -1, pad;
+    gs_point pt[3];
+    int i, i0, i1, span = 0, code = 0;
+    bool by_x, have_span = false;
+    patch_color_t c;
+    gx_device_color devc, devc_span;
+
+    /* The devices, which accumulate the shading area,
+       need the general algorithm. */
+    if ((*dev_proc(dev, dev_spec_op))(dev, gxdso_pattern_shading_area, NULL, 0) > 0)
+        return 0;
+    if (d2 == 0 || x0 >= x1 || y0 >= y1)
+        return 0;
+    /* Compute the parameter as an affine function of device coordinates. */
+    if (gs_point_transform_inverse(0, 0, pmat, &pt[0]) < 0 ||
+        gs_point_transform_inverse(1, 0, pmat, &pt[1]) < 0 ||
+        gs_point_transform_inverse(0, 1, pmat, &pt[2]) < 0)
+        return 0;
+    for (i = 0; i < 3; i++)
+        pt[i].x = ((pt[i].x - psh->params.Coords[0]) * pfs->delta.x +
+                   (pt[i].y - psh->params.Coords[1]) * pfs->delta.y) / d2;
+    t00 = pt[0].x;
+    tx = pt[1].x - t00;
+    ty = pt[2].x - t00;
+    /* Allow a parameter change, which is much smaller than
+       a color grade, across the whole area. */
+    if (any_abs(ty) * (y1 - y0) < 1e-6) {
+        by_x = true;
+        i0 = x0, i1 = x1, dt = tx;
+        t00 += ty * (y0 + y1) / 2;
+    } else if (any_abs(tx) * (x1 - x0) < 1e-6) {
+        by_x = false;
+        i0 = y0, i1 = y1, dt = ty;
+        t00 += tx * (x0 + x1) / 2;
+    } else
+        return 0;
+    /* Emulate INTERPATCH_PADDING : paint pixels, which are touched by the area. */
+    pad = any_abs(dt) * fixed2float(INTERPATCH_PADDING);
+    c.t[1] = 0;
+    for (i = i0; i <= i1; i++) {
+        bool paint = false;
+
+        if (i < i1) {
+            t = t00 + dt * (i + 0.5);
+            paint = true;
+            if (t < 0) {
+                if (t < -pad && !psh->params.Extend[0])
+                    paint = false;
+                t = 0;
+            } else if (t > 1) {
+                if (t > 1 + pad && !psh->params.Extend[1])
+                    paint = false;
+                t = 1;
+            }
+            if (paint && t != tprev) {
+                c.t[0] = t * dd + d0;
+                patch_resolve_color(&c, pfs1);
+                code = patch_color_to_device_color(pfs1, &c, &devc);
+                if (code < 0)
+                    return code;
+                tprev = t;
+            }
+        }
+        if (have_span && (!paint || !gx_device_color_equal(&devc, &devc_span))) {
+            if (by_x)
+                code = gx_fill_rectangle_device_rop(span, y0, i - span, y1 - y0,
+                                                    &devc_span, dev, pfs1->pis->log_op);
+            else
+                code = gx_fill_rectangle_device_rop(x0, span, x1 - x0, i - span,
+                                                    &devc_span, dev, pfs1->pis->log_op);
+            if (code < 0)
+                return code;
+            have_span = false;
+        }
+        if (paint && !have_span) {
+            devc_span = devc;
+            span = i;
+            have_span = true;
+        }
+    }
+    return 1;
+}
+
 static inline int
 gs_shading_A_fill_rectangle_aux(const gs_shading_t * psh0, const gs_rect * rect,
                             const gs_fixed_rect *clip_rect,
@@ -268,6 +371,13 @@ gs_shading_A_fill_rectangle_aux(const gs_shading_t * psh0, const gs_rect * rect,
     gs_distance_transform(state.delta.x, state.delta.y, &ctm_only(pis),
                           &dist);
     state.length = hypot(dist.x, dist.y);	/* device space line length */
+    code = A_fill_direct(&state, &pfs1, clip_rect);
+    if (code != 0) {
+        if (pfs1.icclink != NULL) gsicc_release_link(pfs1.icclink);
+        if (term_patch_fill_state(&pfs1))
+            return_error(gs_error_unregistered); /* Must not happen. */
+        return code < 0 ? code : 0;
+    }
     code = A_fill_region(&state, &pfs1);
     if (psh->params.Extend[0] && t0 > t_rect.p.y) {
         if (code < 0) {
@@ -145,6 +145,13 @@ struct patch_fill_state_s {
     bool linear_color;
     bool unlinear;
     bool inside;
+    /* The last interpatch padding painted by patch_fill,
+       which a next patch may share with a boundary curve.
+       Only used when nothing else paints between patches. */
+    bool share_paddings;
+    bool padded_curve_valid;
+    gs_fixed_point padded_curve[4];
+    float padded_cc[2][GS_CLIENT_COLOR_MAX_COMPONENTS];
     int color_stack_size;
     int color_stack_step;
     byte *color_stack_ptr;
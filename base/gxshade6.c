@@ -272,6 +272,8 @@ init_patch_fill_state(patch_fill_state_t *pfs)
     pfs->function_arg_shift = 0;
     pfs->linear_color = false;
     pfs->inside = false;
+    pfs->share_paddings = false;
+    pfs->padded_curve_valid = false;
     pfs->n_color_args = 1;
 #ifdef MAX_SHADING_RESOLUTION
     pfs->decomposition_limit = float2fixed(min(pfs->dev->HWResolution[0],
@@ -457,6 +459,7 @@ gs_shading_Cp_fill_rectangle(const gs_shading_t * psh0, const gs_rect * rect,
         if (state.icclink != NULL) gsicc_release_link(state.icclink);
         return code;
     }
+    state.share_paddings = true;
     if (VD_TRACE_TENSOR_PATCH && vd_allowed('s')) {
         vd_get_dc('s');
         vd_set_shift(0, 0);
@@ -554,6 +557,7 @@ gs_shading_Tpp_fill_rectangle(const gs_shading_t * psh0, const gs_rect * rect,
     code = init_patch_fill_state(&state);
     if(code < 0)
         return code;
+    state.share_paddings = true;
     if (VD_TRACE_TENSOR_PATCH && vd_allowed('s')) {
         vd_get_dc('s');
         vd_set_shift(0, 0);
@@ -3118,6 +3122,8 @@ gx_init_patch_fill_state_for_clist(gx_device *dev, patch_fill_state_t *pfs, gs_m
     pfs->linear_color = true;
     pfs->unlinear = false; /* Because it is used when fill_linear_color_triangle was called. */
     pfs->inside = false;
+    pfs->share_paddings = false;
+    pfs->padded_curve_valid = false;
     pfs->color_stack_size = 0;
     pfs->color_stack_step = dev->color_info.num_components;
     pfs->color_stack_ptr = NULL; /* fixme */
@@ -4261,6 +4267,92 @@ gx_shade_background(gx_device *pdev, const gs_fixed_rect *rect,
             &le, &re, le.start.y, le.end.y, false, pdevc, log_op);
 }
 
+static int
+is_patch_color_linear(patch_fill_state_t *pfs, const tensor_patch *p)
+{   /* returns : 1 = linear, 0 = don't know, <0 = error. */
+    /* Apply the quadrangle color tests to the whole patch,
+       so that its quadrangles needn't repeat them.
+       Sets pfs->monotonic_color when the color is monotonic
+       over the patch, even if it is not linear. */
+    if (!pfs->monotonic_color) {
+        float t0[2], t1[2];
+        uint mask;
+        int i, code;
+
+        /* Unlike is_quadrangle_color_monotonic, take the range
+           of all 4 corners, because the patch is big. */
+        for (i = 0; i < 2; i++) {
+            t0[i] = min(min(p->c[0][0]->t[i], p->c[0][1]->t[i]),
+                        min(p->c[1][0]->t[i], p->c[1][1]->t[i]));
+            t1[i] = max(max(p->c[0][0]->t[i], p->c[0][1]->t[i]),
+                        max(p->c[1][0]->t[i], p->c[1][1]->t[i]));
+        }
+        code = gs_function_is_monotonic(pfs->Function, t0, t1, &mask);
+        if (code < 0)
+            return code;
+        if (mask)
+            return 0;
+        pfs->monotonic_color = true;
+    }
+    if (!pfs->unlinear) {
+        shading_vertex_t qq[2][2];
+        wedge_vertex_list_t l[4];
+        quadrangle_patch q;
+        int code;
+
+        make_quadrangle(p, qq, l, &q);
+        code = is_quadrangle_color_linear_by_u(pfs, &q);
+        if (code <= 0)
+            return code;
+        code = is_quadrangle_color_linear_by_v(pfs, &q);
+        if (code <= 0)
+            return code;
+        code = is_quadrangle_color_linear_by_diagonals(pfs, &q);
+        if (code <= 0)
+            return code;
+    }
+    pfs->linear_color = true;
+    return 1;
+}
+
+static bool
+is_padded_curve(const patch_fill_state_t *pfs, const gs_fixed_point pole[4],
+                const float *cc0, const float *cc1)
+{
+    /* Check whether the last patch ended with painting
+       the interpatch padding of same curve, in either direction. */
+    const gs_fixed_point *q = pfs->padded_curve;
+    uint size = sizeof(cc0[0]) * (pfs->Function ? 2 : pfs->num_components);
+
+    if (!pfs->padded_curve_valid)
+        return false;
+    if (pole[0].x == q[0].x && pole[0].y == q[0].y &&
+        pole[1].x == q[1].x && pole[1].y == q[1].y &&
+        pole[2].x == q[2].x && pole[2].y == q[2].y &&
+        pole[3].x == q[3].x && pole[3].y == q[3].y)
+        return !memcmp(cc0, pfs->padded_cc[0], size) &&
+               !memcmp(cc1, pfs->padded_cc[1], size);
+    if (pole[0].x == q[3].x && pole[0].y == q[3].y &&
+        pole[1].x == q[2].x && pole[1].y == q[2].y &&
+        pole[2].x == q[1].x && pole[2].y == q[1].y &&
+        pole[3].x == q[0].x && pole[3].y == q[0].y)
+        return !memcmp(cc0, pfs->padded_cc[1], size) &&
+               !memcmp(cc1, pfs->padded_cc[0], size);
+    return false;
+}
+
+static void
+set_padded_curve(patch_fill_state_t *pfs, const gs_fixed_point pole[4],
+                const float *cc0, const float *cc1)
+{
+    uint size = sizeof(cc0[0]) * (pfs->Function ? 2 : pfs->num_components);
+
+    memcpy(pfs->padded_curve, pole, sizeof(pfs->padded_curve));
+    memcpy(pfs->padded_cc[0], cc0, size);
+    memcpy(pfs->padded_cc[1], cc1, size);
+    pfs->padded_curve_valid = true;
+}
+
 int
 patch_fill(patch_fill_state_t *pfs, const patch_curve_t curve[4],
            const gs_fixed_point interior[4],
@@ -4271,6 +4363,9 @@ patch_fill(patch_fill_state_t *pfs, const patch_curve_t curve[4],
     patch_color_t *c[4];
     int kv[4], kvm, ku[4], kum;
     int code = 0;
+    int wedge_type = interpatch_padding | inpatch_wedge;
+    bool share_paddings = pfs->share_paddings;
+    bool monotonic_color_save = pfs->monotonic_color;
     byte *color_stack_ptr = reserve_colors_inline(pfs, c, 4); /* Can't fail */
 
     p.c[0][0] = c[0];
@@ -4306,6 +4401,7 @@ patch_fill(patch_fill_state_t *pfs, const patch_curve_t curve[4],
         int64_t s2 = (int64_t)d23x * d30y - (int64_t)d23y * d30x;
         int s = (s1 + s2 > 0 ? 1 : 3), i, j, k, jj, l = (s == 1 ? 0 : 1);
 
+        share_paddings = false; /* Each patch is clipped separately. */
         gx_path_init_local(&path, pdev->memory);
         if (is_x_bended(&p) || is_y_bended(&p)) {
             /* The patch possibly is self-overlapping,
@@ -4346,11 +4442,19 @@ patch_fill(patch_fill_state_t *pfs, const patch_curve_t curve[4],
     ku[2] = curve_samples(pfs, p.pole[2], 1, pfs->fixed_flat);
     ku[3] = curve_samples(pfs, p.pole[3], 1, pfs->fixed_flat);
     kum = max(max(ku[0], ku[1]), max(ku[2], ku[3]));
+    code = is_patch_color_linear(pfs, &p);
+    if (code < 0)
+        goto out;
+    /* A patch of a mesh often starts at the curve,
+       where the previous patch painted its last padding. */
+    if (share_paddings && is_padded_curve(pfs, p.pole[0],
+                curve[0].vertex.cc, curve[3].vertex.cc))
+        wedge_type = inpatch_wedge;
 #   if NOFILL_TEST
         dbg_nofill = false;
 #   endif
         code = fill_wedges(pfs, ku[0], kum, p.pole[0], 1, p.c[0][0], p.c[0][1],
-        interpatch_padding | inpatch_wedge);
+        wedge_type);
     if (code >= 0) {
         /* We would like to apply iterations for enumerating the kvm curve parts,
            but the roundinmg errors would be too complicated due to
@@ -4368,7 +4472,12 @@ patch_fill(patch_fill_state_t *pfs, const patch_curve_t curve[4],
     if (code >= 0)
         code = fill_wedges(pfs, ku[3], kum, p.pole[3], 1, p.c[1][0], p.c[1][1],
                 interpatch_padding | inpatch_wedge);
+    pfs->padded_curve_valid = false;
+    if (code >= 0 && share_paddings)
+        set_padded_curve(pfs, p.pole[3], curve[1].vertex.cc, curve[2].vertex.cc);
 out:
+    pfs->monotonic_color = monotonic_color_save;
+    pfs->linear_color = false;
     release_colors_inline(pfs, color_stack_ptr, 4);
     return code;
 }
@@ -554,6 +554,7 @@ sjpx_luratech_h=$(GLSRC)sjpx_luratech.h $(scommon_h)
 sjpx_openjpeg_h=$(GLSRC)sjpx_openjpeg.h $(scommon_h) $(openjpeg_h)
 spdiffx_h=$(GLSRC)spdiffx.h
 spngpx_h=$(GLSRC)spngpx.h
+spredsse2_h=$(GLSRC)spredsse2.h
 spprint_h=$(GLSRC)spprint.h
 spsdf_h=$(GLSRC)spsdf.h $(gsparam_h)
 srlx_h=$(GLSRC)srlx.h
@@ -1215,7 +1216,7 @@ gxdownscale_h=$(GLSRC)gxdownscale.h $(gsmemory_h) $(gxdevcli_h) $(ctype__h) \
 downscale_=$(GLOBJ)gxdownscale.$(OBJ)
 
 $(GLOBJ)gxdownscale.$(OBJ) : $(GLSRC)gxdownscale.c $(AK) \
- $(gxdownscale_h) $(gserrors_h) $(gdevprn_h) $(MAKEDIRS)
+ $(gxdownscale_h) $(gserrors_h) $(gdevprn_h) $(gdebug_h) $(MAKEDIRS)
 	$(GLCC) $(GLO_)gxdownscale.$(OBJ) $(C_) $(GLSRC)gxdownscale.c
 
 ###### Create a pseudo-"feature" for the entire graphics library.
@@ -1344,7 +1345,7 @@ $(GLD)sfile.dev : $(LIB_MAK) $(ECHOGS_XE) $(sfile_)
 	$(SETMOD) $(GLD)sfile $(sfile_)
 
 $(GLOBJ)sfxcommon.$(OBJ) : $(GLSRC)sfxcommon.c $(AK) $(stdio__h)\
- $(memory__h) $(unistd__h) $(gsmemory_h) $(gp_h) $(stream_h)\
+ $(memory__h) $(unistd__h) $(fcntl__h) $(gsmemory_h) $(gp_h) $(stream_h)\
  $(gserrors_h) $(MAKEDIRS)
 	$(GLCC) $(GLO_)sfxcommon.$(OBJ) $(C_) $(GLSRC)sfxcommon.c
 
@@ -1697,7 +1698,7 @@ $(GLD)sjpx_openjpeg.dev : $(LIB_MAK) $(ECHOGS_XE) \
 
 $(GLOBJ)sjpx_openjpeg.$(OBJ) : $(GLSRC)sjpx_openjpeg.c $(AK) \
  $(memory__h) $(malloc__h) $(gserror_h) $(gserrors_h) \
- $(gdebug_h) $(strimpl_h) $(sjpx_openjpeg_h) $(MAKEDIRS)
+ $(gdebug_h) $(strimpl_h) $(gpsync_h) $(sjpx_openjpeg_h) $(MAKEDIRS)
 	$(GLJPXOPJCC) $(GLO_)sjpx_openjpeg.$(OBJ) \
 		$(C_) -DOPJ_STATIC $(GLSRC)sjpx_openjpeg.c
 
@@ -1709,7 +1710,7 @@ $(GLD)pdiff.dev : $(LIB_MAK) $(ECHOGS_XE) $(pdiff_)
 	$(SETMOD) $(GLD)pdiff $(pdiff_)
 
 $(GLOBJ)spdiff.$(OBJ) : $(GLSRC)spdiff.c $(AK) $(memory__h) $(stdio__h)\
- $(spdiffx_h) $(strimpl_h) $(MAKEDIRS)
+ $(spdiffx_h) $(spredsse2_h) $(strimpl_h) $(MAKEDIRS)
 	$(GLCC) $(GLO_)spdiff.$(OBJ) $(C_) $(GLSRC)spdiff.c
 
 # ---------------- PNG pixel prediction filters ---------------- #
@@ -1720,7 +1721,7 @@ $(GLD)pngp.dev : $(LIB_MAK) $(ECHOGS_XE) $(pngp_)
 	$(SETMOD) $(GLD)pngp $(pngp_)
 
 $(GLOBJ)spngp.$(OBJ) : $(GLSRC)spngp.c $(AK) $(memory__h)\
- $(spngpx_h) $(strimpl_h) $(MAKEDIRS)
+ $(spngpx_h) $(spredsse2_h) $(strimpl_h) $(MAKEDIRS)
 	$(GLCC) $(GLO_)spngp.$(OBJ) $(C_) $(GLSRC)spngp.c
 
 # ---------------- RunLength filters ---------------- #
@@ -3020,8 +3021,8 @@ $(GLOBJ)gxshade1.$(OBJ) : $(GLSRC)gxshade1.c $(AK) $(gx_h)\
  $(gserrors_h) $(math__h) $(memory__h) $(vdtrace_h)\
  $(gscoord_h) $(gsmatrix_h) $(gspath_h) $(gsptype2_h)\
  $(gxcspace_h) $(gxdcolor_h) $(gxfarith_h) $(gxfixed_h) $(gxistate_h)\
- $(gxpath_h) $(gxshade_h) $(gxshade4_h) $(gxdevcli_h) $(gsicc_cache_h)\
- $(MAKEDIRS)
+ $(gxpath_h) $(gxshade_h) $(gxshade4_h) $(gxdevcli_h) $(gxdevsop_h)\
+ $(gsicc_cache_h) $(MAKEDIRS)
 	$(GLCC) $(GLO_)gxshade1.$(OBJ) $(C_) $(GLSRC)gxshade1.c
 
 $(GLOBJ)gxshade4.$(OBJ) : $(GLSRC)gxshade4.c $(AK) $(gx_h)\
@@ -102,11 +102,17 @@ typedef hcd_code cfd_node;
 #define run2_pass (-4)
 #define run2_horizontal (-5)
 
+/*
+ * The first-level tables are indexed by this many bits of the code.  Wider
+ * tables resolve more codes with a single lookup, but get_run needs the
+ * bits with hcd_ensure_bits, so they can't be wider than 8.  scfdtab.c
+ * is generated by scfdgen.c, and must be regenerated if these change.
+ */
 #define cfd_white_initial_bits 8
 #define cfd_white_min_bits 4	/* shortest white run */
 extern const cfd_node cf_white_decode[];
 
-#define cfd_black_initial_bits 7
+#define cfd_black_initial_bits 8
 #define cfd_black_min_bits 2	/* shortest black run */
 extern const cfd_node cf_black_decode[];
 
@@ -130,6 +136,37 @@ extern const cfd_node cf_uncompressed_decode[];
 #define cf_byte_run_length byte_bit_run_length_neg
 #define cf_byte_run_length_0 byte_bit_run_length_0
 
+/*
+ * The scanning loops below can read some bytes beyond the byte that stops
+ * them: the buffers they scan must have cf_row_pad bytes of (initialized)
+ * space after the raster, and must contain a byte that stops the scan at
+ * or before the end of the raster.
+ */
+#define cf_row_pad 16
+
+/*
+ * With SSE2, long runs are skipped 16 bytes (128 pixels) at a time before
+ * the byte-wise loops take over: the white space between the words of a
+ * scanned text page, and the blank lines between lines of text, are often
+ * far longer than the 32 pixels a pass of the byte-wise loop covers.
+ * Skip the blocks of 16 bytes from p + offset on in which every byte is
+ * fill_byte, adding 128 to rlen for each.
+ */
+#ifdef HAVE_SSE2
+#  include <emmintrin.h>
+#  define skip_pixel_blocks(p, offset, fill_byte, rlen)\
+    BEGIN\
+        const __m128i fill_ = _mm_set1_epi8((char)(fill_byte));\
+\
+        while (_mm_movemask_epi8(_mm_cmpeq_epi8(fill_,\
+                    _mm_loadu_si128((const __m128i *)((p) + (offset))))) ==\
+               0xffff)\
+            p += 16, rlen += 128;\
+    END
+#else
+#  define skip_pixel_blocks(p, offset, fill_byte, rlen) DO_NOTHING
+#endif
+
 /* Skip over white pixels to find the next black pixel in the input. */
 /* Store the run length in rlen, and update data, p, and count. */
 /* There are many more white pixels in typical input than black pixels, */
@@ -255,6 +292,7 @@ BEGIN\
             if ( p[0] ) { data = p[0]; p += 1; rlen -= 8; }\
             else if ( p[1] ) { data = p[1]; p += 2; }\
             else {\
+                skip_pixel_blocks(p, 2, 0, rlen);\
                 while ( !(p[2] | p[3] | p[4] | p[5]) )\
                     p += 4, rlen += 32;\
                 if ( p[2] ) {\
@@ -271,6 +309,7 @@ BEGIN\
             if ( p[0] != 0xff ) { data = (byte)~p[0]; p += 1; rlen -= 8; }\
             else if ( p[1] != 0xff ) { data = (byte)~p[1]; p += 2; }\
             else {\
+                skip_pixel_blocks(p, 2, 0xff, rlen);\
                 while ( (p[2] & p[3] & p[4] & p[5]) == 0xff )\
                     p += 4, rlen += 32;\
                 if ( p[2] != 0xff ) {\
@@ -297,6 +336,7 @@ END
 BEGIN\
     rlen = cf_byte_run_length[count & 7][data];\
     if ( rlen >= 8 ) {\
+        skip_pixel_blocks(p, 0, ~white_byte, rlen);\
         if ( white_byte == 0 )\
             for ( ; ; p += 4, rlen += 32 ) {\
                 if ( p[0] != 0xff ) { data = p[0]; p += 1; rlen -= 8; break; }\
@@ -45,19 +45,20 @@ s_CFD_init(stream_state * st)
     byte white = (ss->BlackIs1 ? 0 : 0xff);
 
     s_hcd_init_inline(ss);
-    /* Because skip_white_pixels can look as many as 4 bytes ahead, */
-    /* we need to allow 4 extra bytes at the end of the row buffers. */
-    ss->lbuf = gs_alloc_bytes(st->memory, raster + 4, "CFD lbuf");
+    /* Because skip_white_pixels can look ahead of the byte that stops */
+    /* it, we need to allow extra bytes at the end of the row buffers. */
+    ss->lbuf = gs_alloc_bytes(st->memory, raster + cf_row_pad, "CFD lbuf");
     ss->lprev = 0;
     if (ss->lbuf == 0)
         return ERRC;		/****** WRONG ******/
-    memset(ss->lbuf, white, raster + 4);  /* + 4 for Valgrind */
+    memset(ss->lbuf, white, raster + cf_row_pad);  /* pad for Valgrind */
     if (ss->K != 0) {
-        ss->lprev = gs_alloc_bytes(st->memory, raster + 4, "CFD lprev");
+        ss->lprev = gs_alloc_bytes(st->memory, raster + cf_row_pad,
+                                   "CFD lprev");
         if (ss->lprev == 0)
             return ERRC;	/****** WRONG ******/
         /* Clear the initial reference line for 2-D encoding. */
-        memset(ss->lprev, white, raster + 4); /* + 4 for Valgrind */
+        memset(ss->lprev, white, raster + cf_row_pad); /* for Valgrind */
         /* Ensure that the scan of the reference line will stop. */
         ss->lprev[raster] = 0xa0;
     }
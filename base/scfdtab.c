@@ -21,7 +21,7 @@
 /* Consult those files for the licensing terms and conditions. */
 
 #include "std.h"
-#include "scommon.h"		/* for scf.h */
+#include "scommon.h"            /* for scf.h */
 #include "scf.h"
 
 /* White decoding table. */
@@ -334,22 +334,45 @@ const cfd_node cf_white_decode[] = {
 
 /* Black decoding table. */
 const cfd_node cf_black_decode[] = {
-        { 128, 12 },
-        { 160, 13 },
-        { 224, 12 },
         { 256, 12 },
+        { 272, 12 },
+        { 288, 13 },
+        { 320, 13 },
+        { 13, 8 },
+        { 352, 12 },
+        { 368, 12 },
+        { 14, 8 },
+        { 10, 7 },
         { 10, 7 },
         { 11, 7 },
-        { 288, 12 },
+        { 11, 7 },
+        { 384, 12 },
+        { 400, 12 },
         { 12, 7 },
+        { 12, 7 },
+        { 9, 6 },
         { 9, 6 },
         { 9, 6 },
+        { 9, 6 },
+        { 8, 6 },
+        { 8, 6 },
         { 8, 6 },
         { 8, 6 },
         { 7, 5 },
         { 7, 5 },
         { 7, 5 },
         { 7, 5 },
+        { 7, 5 },
+        { 7, 5 },
+        { 7, 5 },
+        { 7, 5 },
+        { 6, 4 },
+        { 6, 4 },
+        { 6, 4 },
+        { 6, 4 },
+        { 6, 4 },
+        { 6, 4 },
+        { 6, 4 },
         { 6, 4 },
         { 6, 4 },
         { 6, 4 },
@@ -358,6 +381,11 @@ const cfd_node cf_black_decode[] = {
         { 6, 4 },
         { 6, 4 },
         { 6, 4 },
+        { 6, 4 },
+        { 5, 4 },
+        { 5, 4 },
+        { 5, 4 },
+        { 5, 4 },
         { 5, 4 },
         { 5, 4 },
         { 5, 4 },
@@ -366,6 +394,20 @@ const cfd_node cf_black_decode[] = {
         { 5, 4 },
         { 5, 4 },
         { 5, 4 },
+        { 5, 4 },
+        { 5, 4 },
+        { 5, 4 },
+        { 5, 4 },
+        { 1, 3 },
+        { 1, 3 },
+        { 1, 3 },
+        { 1, 3 },
+        { 1, 3 },
+        { 1, 3 },
+        { 1, 3 },
+        { 1, 3 },
+        { 1, 3 },
+        { 1, 3 },
         { 1, 3 },
         { 1, 3 },
         { 1, 3 },
@@ -382,6 +424,25 @@ const cfd_node cf_black_decode[] = {
         { 1, 3 },
         { 1, 3 },
         { 1, 3 },
+        { 1, 3 },
+        { 1, 3 },
+        { 1, 3 },
+        { 1, 3 },
+        { 1, 3 },
+        { 1, 3 },
+        { 4, 3 },
+        { 4, 3 },
+        { 4, 3 },
+        { 4, 3 },
+        { 4, 3 },
+        { 4, 3 },
+        { 4, 3 },
+        { 4, 3 },
+        { 4, 3 },
+        { 4, 3 },
+        { 4, 3 },
+        { 4, 3 },
+        { 4, 3 },
         { 4, 3 },
         { 4, 3 },
         { 4, 3 },
@@ -398,6 +459,41 @@ const cfd_node cf_black_decode[] = {
         { 4, 3 },
         { 4, 3 },
         { 4, 3 },
+        { 4, 3 },
+        { 4, 3 },
+        { 4, 3 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
+        { 3, 2 },
         { 3, 2 },
         { 3, 2 },
         { 3, 2 },
@@ -462,8 +558,40 @@ const cfd_node cf_black_decode[] = {
         { 2, 2 },
         { 2, 2 },
         { 2, 2 },
-        { -2, 4 },
-        { -2, 4 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { 2, 2 },
+        { -2, 3 },
+        { -2, 3 },
         { -1, 0 },
         { -1, 0 },
         { -1, 0 },
@@ -477,183 +605,151 @@ const cfd_node cf_black_decode[] = {
         { -1, 0 },
         { -1, 0 },
         { -1, 0 },
-        { -3, 5 },
-        { 1792, 4 },
-        { 1792, 4 },
-        { 1984, 5 },
-        { 2048, 5 },
-        { 2112, 5 },
-        { 2176, 5 },
-        { 2240, 5 },
-        { 2304, 5 },
-        { 1856, 4 },
-        { 1856, 4 },
-        { 1920, 4 },
-        { 1920, 4 },
-        { 2368, 5 },
-        { 2432, 5 },
-        { 2496, 5 },
-        { 2560, 5 },
-        { 18, 3 },
-        { 18, 3 },
-        { 18, 3 },
-        { 18, 3 },
-        { 18, 3 },
-        { 18, 3 },
-        { 18, 3 },
-        { 18, 3 },
-        { 52, 5 },
-        { 52, 5 },
-        { 640, 6 },
-        { 704, 6 },
-        { 768, 6 },
-        { 832, 6 },
-        { 55, 5 },
-        { 55, 5 },
-        { 56, 5 },
-        { 56, 5 },
-        { 1280, 6 },
-        { 1344, 6 },
-        { 1408, 6 },
-        { 1472, 6 },
-        { 59, 5 },
-        { 59, 5 },
-        { 60, 5 },
-        { 60, 5 },
-        { 1536, 6 },
-        { 1600, 6 },
-        { 24, 4 },
-        { 24, 4 },
-        { 24, 4 },
-        { 24, 4 },
-        { 25, 4 },
-        { 25, 4 },
-        { 25, 4 },
-        { 25, 4 },
-        { 1664, 6 },
-        { 1728, 6 },
-        { 320, 5 },
-        { 320, 5 },
-        { 384, 5 },
-        { 384, 5 },
-        { 448, 5 },
-        { 448, 5 },
-        { 512, 6 },
-        { 576, 6 },
-        { 53, 5 },
-        { 53, 5 },
-        { 54, 5 },
-        { 54, 5 },
-        { 896, 6 },
-        { 960, 6 },
-        { 1024, 6 },
-        { 1088, 6 },
-        { 1152, 6 },
-        { 1216, 6 },
-        { 64, 3 },
-        { 64, 3 },
-        { 64, 3 },
-        { 64, 3 },
-        { 64, 3 },
-        { 64, 3 },
-        { 64, 3 },
-        { 64, 3 },
-        { 13, 1 },
-        { 13, 1 },
-        { 13, 1 },
-        { 13, 1 },
-        { 13, 1 },
-        { 13, 1 },
-        { 13, 1 },
-        { 13, 1 },
-        { 13, 1 },
-        { 13, 1 },
-        { 13, 1 },
-        { 13, 1 },
-        { 13, 1 },
-        { 13, 1 },
-        { 13, 1 },
-        { 13, 1 },
-        { 23, 4 },
-        { 23, 4 },
-        { 50, 5 },
-        { 51, 5 },
-        { 44, 5 },
-        { 45, 5 },
-        { 46, 5 },
-        { 47, 5 },
-        { 57, 5 },
-        { 58, 5 },
-        { 61, 5 },
-        { 256, 5 },
-        { 16, 3 },
-        { 16, 3 },
-        { 16, 3 },
-        { 16, 3 },
-        { 17, 3 },
-        { 17, 3 },
-        { 17, 3 },
-        { 17, 3 },
-        { 48, 5 },
-        { 49, 5 },
-        { 62, 5 },
-        { 63, 5 },
-        { 30, 5 },
-        { 31, 5 },
-        { 32, 5 },
-        { 33, 5 },
-        { 40, 5 },
-        { 41, 5 },
-        { 22, 4 },
-        { 22, 4 },
-        { 14, 1 },
-        { 14, 1 },
-        { 14, 1 },
-        { 14, 1 },
-        { 14, 1 },
-        { 14, 1 },
-        { 14, 1 },
-        { 14, 1 },
-        { 14, 1 },
-        { 14, 1 },
-        { 14, 1 },
-        { 14, 1 },
-        { 14, 1 },
-        { 14, 1 },
-        { 14, 1 },
-        { 14, 1 },
-        { 15, 2 },
-        { 15, 2 },
-        { 15, 2 },
-        { 15, 2 },
-        { 15, 2 },
-        { 15, 2 },
-        { 15, 2 },
-        { 15, 2 },
-        { 128, 5 },
-        { 192, 5 },
-        { 26, 5 },
-        { 27, 5 },
-        { 28, 5 },
-        { 29, 5 },
-        { 19, 4 },
-        { 19, 4 },
-        { 20, 4 },
-        { 20, 4 },
-        { 34, 5 },
-        { 35, 5 },
-        { 36, 5 },
-        { 37, 5 },
-        { 38, 5 },
-        { 39, 5 },
-        { 21, 4 },
-        { 21, 4 },
-        { 42, 5 },
-        { 43, 5 },
-        { 0, 3 },
-        { 0, 3 },
-        { 0, 3 },
-        { 0, 3 }
+        { -3, 4 },
+        { 1792, 3 },
+        { 1792, 3 },
+        { 1984, 4 },
+        { 2048, 4 },
+        { 2112, 4 },
+        { 2176, 4 },
+        { 2240, 4 },
+        { 2304, 4 },
+        { 1856, 3 },
+        { 1856, 3 },
+        { 1920, 3 },
+        { 1920, 3 },
+        { 2368, 4 },
+        { 2432, 4 },
+        { 2496, 4 },
+        { 2560, 4 },
+        { 18, 2 },
+        { 18, 2 },
+        { 18, 2 },
+        { 18, 2 },
+        { 18, 2 },
+        { 18, 2 },
+        { 18, 2 },
+        { 18, 2 },
+        { 52, 4 },
+        { 52, 4 },
+        { 640, 5 },
+        { 704, 5 },
+        { 768, 5 },
+        { 832, 5 },
+        { 55, 4 },
+        { 55, 4 },
+        { 56, 4 },
+        { 56, 4 },
+        { 1280, 5 },
+        { 1344, 5 },
+        { 1408, 5 },
+        { 1472, 5 },
+        { 59, 4 },
+        { 59, 4 },
+        { 60, 4 },
+        { 60, 4 },
+        { 1536, 5 },
+        { 1600, 5 },
+        { 24, 3 },
+        { 24, 3 },
+        { 24, 3 },
+        { 24, 3 },
+        { 25, 3 },
+        { 25, 3 },
+        { 25, 3 },
+        { 25, 3 },
+        { 1664, 5 },
+        { 1728, 5 },
+        { 320, 4 },
+        { 320, 4 },
+        { 384, 4 },
+        { 384, 4 },
+        { 448, 4 },
+        { 448, 4 },
+        { 512, 5 },
+        { 576, 5 },
+        { 53, 4 },
+        { 53, 4 },
+        { 54, 4 },
+        { 54, 4 },
+        { 896, 5 },
+        { 960, 5 },
+        { 1024, 5 },
+        { 1088, 5 },
+        { 1152, 5 },
+        { 1216, 5 },
+        { 64, 2 },
+        { 64, 2 },
+        { 64, 2 },
+        { 64, 2 },
+        { 64, 2 },
+        { 64, 2 },
+        { 64, 2 },
+        { 64, 2 },
+        { 23, 3 },
+        { 23, 3 },
+        { 50, 4 },
+        { 51, 4 },
+        { 44, 4 },
+        { 45, 4 },
+        { 46, 4 },
+        { 47, 4 },
+        { 57, 4 },
+        { 58, 4 },
+        { 61, 4 },
+        { 256, 4 },
+        { 16, 2 },
+        { 16, 2 },
+        { 16, 2 },
+        { 16, 2 },
+        { 17, 2 },
+        { 17, 2 },
+        { 17, 2 },
+        { 17, 2 },
+        { 48, 4 },
+        { 49, 4 },
+        { 62, 4 },
+        { 63, 4 },
+        { 30, 4 },
+        { 31, 4 },
+        { 32, 4 },
+        { 33, 4 },
+        { 40, 4 },
+        { 41, 4 },
+        { 22, 3 },
+        { 22, 3 },
+        { 15, 1 },
+        { 15, 1 },
+        { 15, 1 },
+        { 15, 1 },
+        { 15, 1 },
+        { 15, 1 },
+        { 15, 1 },
+        { 15, 1 },
+        { 128, 4 },
+        { 192, 4 },
+        { 26, 4 },
+        { 27, 4 },
+        { 28, 4 },
+        { 29, 4 },
+        { 19, 3 },
+        { 19, 3 },
+        { 20, 3 },
+        { 20, 3 },
+        { 34, 4 },
+        { 35, 4 },
+        { 36, 4 },
+        { 37, 4 },
+        { 38, 4 },
+        { 39, 4 },
+        { 21, 3 },
+        { 21, 3 },
+        { 42, 4 },
+        { 43, 4 },
+        { 0, 2 },
+        { 0, 2 },
+        { 0, 2 },
+        { 0, 2 }
 };
 
 /* 2-D decoding table. */
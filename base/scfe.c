@@ -146,18 +146,19 @@ s_CFE_init(register stream_state * st)
     if (columns > cfe_max_width)
         return ERRC;
 /****** WRONG ******/
-    /* Because skip_white_pixels can look as many as 4 bytes ahead, */
-    /* we need to allow 4 extra bytes at the end of the row buffers. */
-    ss->lbuf = gs_alloc_bytes(st->memory, raster + 4, "CFE lbuf");
+    /* Because skip_white_pixels can look ahead of the byte that stops */
+    /* it, we need to allow extra bytes at the end of the row buffers. */
+    ss->lbuf = gs_alloc_bytes(st->memory, raster + cf_row_pad, "CFE lbuf");
     ss->lcode = gs_alloc_bytes(st->memory, code_bytes, "CFE lcode");
     if (ss->lbuf == 0 || ss->lcode == 0) {
         s_CFE_release(st);
         return ERRC;
 /****** WRONG ******/
     }
-    memset(ss->lbuf + raster, 0, 4); /* to pacify Valgrind */
+    memset(ss->lbuf + raster, 0, cf_row_pad); /* to pacify Valgrind */
     if (ss->K != 0) {
-        ss->lprev = gs_alloc_bytes(st->memory, raster + 4, "CFE lprev");
+        ss->lprev = gs_alloc_bytes(st->memory, raster + cf_row_pad,
+                                   "CFE lprev");
         if (ss->lprev == 0) {
             s_CFE_release(st);
             return ERRC;
@@ -165,7 +166,7 @@ s_CFE_init(register stream_state * st)
         }
         /* Clear the initial reference line for 2-D encoding. */
         /* Make sure it is terminated properly. */
-        memset(ss->lprev, (ss->BlackIs1 ? 0 : 0xff), raster + 4); /* +4 to pacify Valgrind */
+        memset(ss->lprev, (ss->BlackIs1 ? 0 : 0xff), raster + cf_row_pad); /* pad to pacify Valgrind */
         if (columns & 7)
             ss->lprev[raster - 1] ^= 0x80 >> (columns & 7);
         else
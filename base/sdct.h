@@ -94,6 +94,8 @@ typedef struct jpeg_decompress_data_s {
     bool faked_eoi;		/* true when fill_input_buffer inserted EOI */
     byte *scanline_buffer;	/* buffer for oversize scanline, or NULL */
     uint bytes_in_scanline;	/* # of bytes remaining to output from same */
+    int scale_log2;		/* IDCT output is 2^scale_log2 times smaller */
+    uint row_copies;		/* # of times to output same again */
 } jpeg_decompress_data;
 
 #define private_st_jpeg_decompress_data()	/* in zfdctd.c */\
@@ -111,6 +113,8 @@ typedef struct stream_DCT_state_s {
     float QFactor;
     int ColorTransform;		/* -1 if not specified */
     bool NoMarker;		/* DCTEncode only */
+    int Reduce;			/* DCTDecode only: 0..3, decode at */
+                                /* 1/2^Reduce size and replicate */
     gs_memory_t *jpeg_memory;	/* heap for library allocations */
     /* This is a pointer to immovable storage. */
     union _jd {
@@ -99,6 +99,8 @@ s_DCTD_init(stream_state * st)
     ss->data.decompress->skip = 0;
     ss->data.decompress->input_eod = false;
     ss->data.decompress->faked_eoi = false;
+    ss->data.decompress->scale_log2 = 0;
+    ss->data.decompress->row_copies = 0;
     ss->phase = 0;
     return 0;
 }
@@ -137,6 +139,29 @@ compact:
     return o - i;
 }
 
+/*
+ * Replicate the samples of a scanline decoded at reduced size, in place,
+ * to fill the full image width.  Return the number of further times the
+ * scanline must be output to fill the image height.
+ */
+static uint
+dctd_expand_scanline(jpeg_decompress_data *jddp)
+{
+    int shift = jddp->scale_log2;
+    int nc = jddp->dinfo.output_components;
+    uint row = jddp->dinfo.output_scanline - 1;
+    uint rows_left = jddp->dinfo.image_height - (row << shift);
+    byte *line = jddp->scanline_buffer;
+    uint x = jddp->dinfo.image_width;
+    int c;
+
+    /* Work backwards, since the source is never to the right of the target. */
+    while (x-- > 0)
+        for (c = nc; --c >= 0;)
+            line[x * nc + c] = line[(x >> shift) * nc + c];
+    return min(rows_left, (uint)1 << shift) - 1;
+}
+
 /* Process a buffer */
 static int
 s_DCTD_process(stream_state * st, stream_cursor_read * pr,
@@ -208,6 +233,14 @@ s_DCTD_process(stream_state * st, stream_cursor_read * pr,
                         break;
                 }
             }
+            /*
+             * If the image will be scaled down, let the IDCT do most of
+             * the work.  We still return the full size image.
+             */
+            if (ss->Reduce > 0) {
+                jddp->dinfo.scale_num = 1;
+                jddp->dinfo.scale_denom = 1 << ss->Reduce;
+            }
             ss->phase = 2;
             /* falls through */
         case 2:		/* start_decompress */
@@ -217,13 +250,29 @@ s_DCTD_process(stream_state * st, stream_cursor_read * pr,
                 (jddp->faked_eoi ? pr->limit : src->next_input_byte - 1);
             if (code == 0)
                 return 0;
+            if (jddp->dinfo.output_width != jddp->dinfo.image_width ||
+                jddp->dinfo.output_height != jddp->dinfo.image_height) {
+                /* Find the scale the library actually used. */
+                int s;
+
+                for (s = 1; s <= ss->Reduce; ++s)
+                    if (jddp->dinfo.output_width ==
+                            (jddp->dinfo.image_width + (1 << s) - 1) >> s &&
+                        jddp->dinfo.output_height ==
+                            (jddp->dinfo.image_height + (1 << s) - 1) >> s)
+                        break;
+                if (s > ss->Reduce)
+                    return ERRC;
+                jddp->scale_log2 = s;
+            }
             ss->scan_line_size =
-                jddp->dinfo.output_width * jddp->dinfo.output_components;
+                jddp->dinfo.image_width * jddp->dinfo.output_components;
             if_debug4('w', "[wdd]width=%u, components=%d, scan_line_size=%u, min_out_size=%u\n",
                       jddp->dinfo.output_width,
                       jddp->dinfo.output_components,
                       ss->scan_line_size, jddp->templat.min_out_size);
-            if (ss->scan_line_size > (uint) jddp->templat.min_out_size) {
+            if (ss->scan_line_size > (uint) jddp->templat.min_out_size ||
+                jddp->scale_log2 > 0) {
                 /* Create a spare buffer for oversize scanline */
                 jddp->scanline_buffer =
                     gs_alloc_bytes_immovable(gs_memory_stable(jddp->memory),
@@ -252,6 +301,11 @@ s_DCTD_process(stream_state * st, stream_cursor_read * pr,
                 if (jddp->bytes_in_scanline != 0)
                     return 1;	/* need more room */
             }
+            if (jddp->row_copies != 0) {
+                jddp->row_copies--;
+                jddp->bytes_in_scanline = ss->scan_line_size;
+                goto dumpbuffer;
+            }
             while (jddp->dinfo.output_height > jddp->dinfo.output_scanline) {
                 int read;
                 byte *samples;
@@ -292,6 +346,8 @@ s_DCTD_process(stream_state * st, stream_cursor_read * pr,
                     return 0;	/* need more data */
                 }
                 if (jddp->scanline_buffer != NULL) {
+                    if (jddp->scale_log2 > 0)
+                        jddp->row_copies = dctd_expand_scanline(jddp);
                     jddp->bytes_in_scanline = ss->scan_line_size;
                     goto dumpbuffer;
                 }
@@ -26,6 +26,13 @@
 #include "sdcparam.h"
 #include "sjpeg.h"
 
+/* Define the DCTDecode-only parameters. */
+static const gs_param_item_t s_DCTD_param_items[] =
+{
+    { "Reduce", gs_param_type_int, offset_of(stream_DCT_state, Reduce) },
+    gs_param_item_end
+};
+
 /* ================ Get parameters ================ */
 
 stream_state_proc_get_params(s_DCTD_get_params, stream_DCT_state);	/* check */
@@ -56,6 +63,7 @@ s_DCTD_put_params(gs_param_list * plist, stream_DCT_state * pdct)
     int code;
 
     if ((code = s_DCT_put_params(plist, pdct)) < 0 ||
+        (code = gs_param_read_items(plist, pdct, s_DCTD_param_items)) < 0 ||
     /*
      * DCTDecode accepts quantization and huffman tables
      * in case these tables have been omitted from the datastream.
@@ -64,5 +72,7 @@ s_DCTD_put_params(gs_param_list * plist, stream_DCT_state * pdct)
         (code = s_DCT_put_quantization_tables(plist, pdct, false)) < 0
         )
         DO_NOTHING;
+    else if (pdct->Reduce < 0 || pdct->Reduce > 3)
+        return_error(gs_error_rangecheck);
     return code;
 }
@@ -19,14 +19,56 @@
 #include "stdio_.h"		/* includes std.h */
 #include "memory_.h"
 #include "unistd_.h"
+#include "fcntl_.h"
 #include "gsmemory.h"
 #include "gp.h"
 #include "gserrors.h"
 #include "stream.h"
 
-#define DEFAULT_BUFFER_SIZE 2048
+/*
+ * The buffer size for file streams, which is also the minimum buffer size
+ * for filters.  Larger buffers mean fewer, larger reads, at the cost of
+ * memory for every open file and filter.
+ */
+#ifndef DEFAULT_BUFFER_SIZE
+#  define DEFAULT_BUFFER_SIZE 2048
+#endif
 const uint file_default_buffer_size = DEFAULT_BUFFER_SIZE;
 
+#ifdef HAVE_POSIX_FADVISE
+/*
+ * While we read a seekable input file, we keep the OS reading the next
+ * FILE_READ_AHEAD_SIZE bytes (or more) in the background, so that on slow
+ * (e.g. network) storage the interpreter doesn't wait for each refill.
+ * We divide the file into windows of that size: when a file is opened,
+ * we ask for the rest of the window that contains the current position
+ * and all of the next window, and whenever reading crosses into another
+ * window, we ask for the window after it.  We don't ask for anything
+ * after a seek, since a PDF file's objects are read in no particular
+ * order; as soon as reading continues into the next window, read-ahead
+ * resumes.  A size of 0 disables this.
+ */
+#ifndef FILE_READ_AHEAD_SIZE
+#  define FILE_READ_AHEAD_SIZE 1048576
+#endif
+const long file_read_ahead_size = FILE_READ_AHEAD_SIZE;
+
+void
+file_read_ahead(int fd, long pos, uint count)
+{
+    long window = file_read_ahead_size;
+    long next;
+
+    if (window <= 0 || pos < 0)
+        return;
+    next = (pos / window + 1) * window;
+    if (count == 0)
+        posix_fadvise(fd, pos, next + window - pos, POSIX_FADV_WILLNEED);
+    else if (pos - count < next - window)
+        posix_fadvise(fd, next, window, POSIX_FADV_WILLNEED);
+}
+#endif
+
 /* Allocate and return a file stream. */
 /* Return 0 if the allocation failed. */
 /* The stream is initialized to an invalid state, so the caller need not */
@@ -129,6 +129,9 @@ sread_fileno(register stream * s, FILE * file, byte * buf, uint len)
     s->file_modes = s->modes;
     s->file_offset = 0;
     s->file_limit = max_long;
+    s->file_pos = curpos;
+    if (seekable)
+        file_read_ahead(fd, curpos, 0);
 }
 
 /* Confine reading to a subfile.  This is primarily for reusable streams. */
@@ -198,6 +201,7 @@ s_fileno_read_seek(register stream * s, long pos)
     s->srptr = s->srlimit = s->cbuf - 1;
     s->end_status = 0;
     s->position = pos;
+    s->file_pos = s->file_offset + pos;
     return 0;
 }
 static int
@@ -227,7 +231,7 @@ again:
     max_count = pw->limit - pw->ptr;
     status = 1;
     if (s->file_limit < max_long) {
-        long limit_count = s->file_offset + s->file_limit - ltell(fd);
+        long limit_count = s->file_offset + s->file_limit - s->file_pos;
 
         if (max_count > limit_count)
             max_count = limit_count, status = EOFC;
@@ -238,9 +242,12 @@ again:
      * Work around this here.
      */
     nread = read(fd, (void *)(pw->ptr + 1), max_count);
-    if (nread > 0)
+    if (nread > 0) {
         pw->ptr += nread;
-    else if (nread == 0)
+        s->file_pos += nread;
+        if (s->file_modes & s_mode_seek)
+            file_read_ahead(fd, s->file_pos, nread);
+    } else if (nread == 0)
         status = EOFC;
     else if (errno_is_retry(errno))	/* Handle System V interrupts */
         goto again;
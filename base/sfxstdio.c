@@ -71,6 +71,8 @@ sread_file(register stream * s, FILE * file, byte * buf, uint len)
     s->file_modes = s->modes;
     s->file_offset = 0;
     s->file_limit = max_long;
+    if (seekable)
+        file_read_ahead(fileno(file), curpos, 0);
 }
 
 /* Confine reading to a subfile.  This is primarily for reusable streams. */
@@ -170,6 +172,8 @@ s_file_read_process(stream_state * st, stream_cursor_read * ignore_pr,
     count = fread(pw->ptr + 1, 1, max_count, file);
     if (count < 0)
         count = 0;
+    else if (count > 0 && (s->file_modes & s_mode_seek))
+        file_read_ahead(fileno(file), ftell(file), count);
     pw->ptr += count;
     process_interrupts(s->memory);
     return (ferror(file) ? ERRC : feof(file) ? EOFC : status);
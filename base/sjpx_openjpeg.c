@@ -22,6 +22,7 @@
 #include "gserrors.h"
 #include "gdebug.h"
 #include "strimpl.h"
+#include "gpsync.h"
 #include "sjpx_openjpeg.h"
 
 
@@ -36,19 +37,41 @@ gs_private_st_simple(st_jpxd_state, stream_jpxd_state,
 
 static int s_opjd_accumulate_input(stream_jpxd_state *state, stream_cursor_read * pr);
 
-/* initialize the steam.
-   this involves allocating the stream and image structures, and
-   initializing the decoder.
+/* run the tier-1 decoding jobs of a tile, one per thread.
+   the last one runs on this thread, as do any we can't start a thread for.
  */
-static int
-s_opjd_init(stream_state * ss)
+static void
+s_opjd_run_jobs(void *client, void (*fn)(void *job), void *jobs, int job_size,
+                int count)
 {
-    stream_jpxd_state *const state = (stream_jpxd_state *) ss;
-	opj_dparameters_t parameters;	/* decompression parameters */
+    gp_thread_id *ids = malloc(sizeof(gp_thread_id) * count);
+    int i;
 
-    if (state->jpx_memory == NULL) {
-        state->jpx_memory = ss->memory->non_gc_memory;
+    for (i = 0; i < count; i++) {
+        void *job = (byte *)jobs + i * job_size;
+
+        if (ids == NULL || i == count - 1 ||
+            gp_thread_start(fn, job, &ids[i]) < 0) {
+            if (ids)
+                ids[i] = NULL;
+            fn(job);
+        }
+    }
+    if (ids) {
+        for (i = 0; i < count; i++)
+            gp_thread_finish(ids[i]);
+        free(ids);
     }
+}
+
+/* (re)create the decoder handle, discarding reduce resolution levels */
+static int
+s_opjd_set_decoder(stream_jpxd_state *state, int reduce)
+{
+    opj_dparameters_t parameters;	/* decompression parameters */
+
+    if (state->opj_dinfo_p)
+        opj_destroy_decompress(state->opj_dinfo_p);
 
     /* get a decoder handle */
     state->opj_dinfo_p = opj_create_decompress(CODEC_JP2);
@@ -61,9 +84,35 @@ s_opjd_init(stream_state * ss)
 
     /* set decoding parameters to default values */
     opj_set_default_decoder_parameters(&parameters);
+    parameters.cp_reduce = reduce;
+    parameters.cp_threads = state->threads;
+    parameters.run_jobs = s_opjd_run_jobs;
+    parameters.run_jobs_client = state;
+    memcpy(parameters.cp_region, state->region, sizeof(parameters.cp_region));
 
     /* setup the decoder decoding parameters using user parameters */
     opj_setup_decoder(state->opj_dinfo_p, &parameters);
+    return 0;
+}
+
+/* initialize the steam.
+   this involves allocating the stream and image structures, and
+   initializing the decoder.
+ */
+static int
+s_opjd_init(stream_state * ss)
+{
+    stream_jpxd_state *const state = (stream_jpxd_state *) ss;
+    int code;
+
+    if (state->jpx_memory == NULL) {
+        state->jpx_memory = ss->memory->non_gc_memory;
+    }
+
+    state->opj_dinfo_p = NULL;
+    code = s_opjd_set_decoder(state, 0);
+    if (code < 0)
+        return code;
 
     state->image = NULL;
     state->inbuf = NULL;
@@ -157,32 +206,172 @@ s_jpxd_ycc_to_rgb(stream_jpxd_state *state)
     return 0;
 }
 
+/* find the smallest number of decomposition levels in the main header
+   of the codestream, that is the most resolution levels we can discard.
+   the codestream may be wrapped in JP2 boxes.
+ */
+static int
+s_jpxd_decomposition_levels(const byte *p, unsigned long len)
+{
+    const byte *end = p + len;
+    int csiz = 0, levels = -1;
+
+#define GET16(q) (((q)[0] << 8) | (q)[1])
+#define GET32(q) (((ulong)GET16(q) << 16) | GET16((q) + 2))
+    if (len >= 12 && GET32(p) == 12 && GET32(p + 4) == 0x6a502020) {
+        /* find the contiguous codestream box */
+        for (;;) {
+            ulong size, type;
+            int header = 8;
+
+            if (end - p < 8)
+                return 0;
+            size = GET32(p);
+            type = GET32(p + 4);
+            if (size == 1) {
+                if (end - p < 16 || GET32(p + 8) != 0)
+                    return 0;
+                size = GET32(p + 12);
+                header = 16;
+            } else if (size == 0)
+                size = end - p;
+            if (type == 0x6a703263) {	/* jp2c */
+                p += header;
+                break;
+            }
+            if (size < header || size > end - p)
+                return 0;
+            p += size;
+        }
+    }
+    if (end - p < 2 || GET16(p) != 0xff4f)	/* SOC */
+        return 0;
+    p += 2;
+    /* the main header ends with the first tile-part */
+    while (end - p >= 4 && GET16(p) != 0xff90) {
+        uint marker = GET16(p), size = GET16(p + 2);
+
+        if (size < 2 || size > end - p - 2)
+            break;
+        switch (marker) {
+            case 0xff51:	/* SIZ */
+                if (size >= 38)
+                    csiz = GET16(p + 38);
+                break;
+            case 0xff52:	/* COD */
+                if (size >= 8 && (levels < 0 || p[9] < levels))
+                    levels = p[9];
+                break;
+            case 0xff53: {	/* COC */
+                int i = 4 + (csiz < 257 ? 1 : 2) + 1;
+
+                if (size >= i && (levels < 0 || p[i] < levels))
+                    levels = p[i];
+                break;
+            }
+        }
+        p += 2 + size;
+    }
+#undef GET16
+#undef GET32
+    return max(levels, 0);
+}
+
+/* scale the components of an image decoded with reduce resolution levels
+   discarded back up to the full size, replicating the samples.
+ */
+static int
+s_jpxd_expand_image(stream_jpxd_state *state, int reduce)
+{
+    opj_image_t *image = state->image;
+    int compno;
+
+    for (compno = 0; compno < image->numcomps; compno++) {
+        opj_image_comp_t *comp = &image->comps[compno];
+        int w = (image->x1 + comp->dx - 1) / comp->dx -
+                (image->x0 + comp->dx - 1) / comp->dx;
+        int h = (image->y1 + comp->dy - 1) / comp->dy -
+                (image->y0 + comp->dy - 1) / comp->dy;
+        int *data, *row;
+        int x, y;
+
+        if (comp->w == w && comp->h == h)
+            continue;
+        data = malloc(sizeof(int) * w * h);
+        if (data == NULL)
+            return_error(gs_error_VMerror);
+        for (y = 0, row = data; y < h; y++, row += w) {
+            const int *src = comp->data + min(y >> reduce, comp->h - 1) * comp->w;
+
+            if (y > 0 && (y >> reduce) == ((y - 1) >> reduce))
+                memcpy(row, row - w, sizeof(int) * w);
+            else
+                for (x = 0; x < w; x++)
+                    row[x] = src[min(x >> reduce, comp->w - 1)];
+        }
+        free(comp->data);
+        comp->data = data;
+        comp->w = w;
+        comp->h = h;
+        comp->factor = 0;
+    }
+    return 0;
+}
+
 static int decode_image(stream_jpxd_state * const state)
 {
     opj_cio_t *cio = NULL;
     int numprimcomp = 0, alpha_comp = -1, compno, rowbytes;
+    int reduce = 0, code;
+
+    /* discard the resolution levels that the caller can do without,
+       as far as every tile-component has them */
+    if (state->reduce > 0) {
+        reduce = min(state->reduce,
+                     s_jpxd_decomposition_levels(state->inbuf, state->inbuf_fill));
+        if (reduce > 0) {
+            code = s_opjd_set_decoder(state, reduce);
+            if (code < 0)
+                return code;
+        }
+    }
 
-    /* open a byte stream */
-    cio = opj_cio_open((opj_common_ptr)state->opj_dinfo_p, state->inbuf, state->inbuf_fill);
-    if (cio == NULL)
-            return ERRC;
+    for (;;) {
+        /* open a byte stream */
+        cio = opj_cio_open((opj_common_ptr)state->opj_dinfo_p, state->inbuf, state->inbuf_fill);
+        if (cio == NULL)
+                return ERRC;
+
+        /* decode the stream and fill the image structure */
+        state->image = opj_decode(state->opj_dinfo_p, cio, state->colorspace == gs_jpx_cs_indexed);
 
-    /* decode the stream and fill the image structure */
-    state->image = opj_decode(state->opj_dinfo_p, cio, state->colorspace == gs_jpx_cs_indexed);
+        /* close the byte stream */
+        opj_cio_close(cio);
+
+        if (state->image != NULL || reduce == 0)
+            break;
+        /* a tile has fewer levels than the main header said; start over */
+        reduce = 0;
+        code = s_opjd_set_decoder(state, 0);
+        if (code < 0)
+            return code;
+    }
     if(state->image == NULL)
     {
         dlprintf("openjpeg: failed to decode image!\n");
-        opj_cio_close(cio);
         return ERRC;
     }
 
-    /* close the byte stream */
-    opj_cio_close(cio);
-
     /* check dimension and prec */
     if (state->image->numcomps == 0)
             return ERRC;
 
+    if (reduce > 0) {
+        code = s_jpxd_expand_image(state, reduce);
+        if (code < 0)
+            return code;
+    }
+
     state->width = state->image->comps[0].w;
     state->height = state->image->comps[0].h;
     state->bpp = state->image->comps[0].prec;
@@ -502,6 +691,9 @@ s_opjd_set_defaults(stream_state * ss) {
 
     state->alpha = false;
     state->colorspace = gs_jpx_cs_rgb;
+    state->reduce = 0;
+    memset(state->region, 0, sizeof(state->region));
+    state->threads = 1;
 }
 
 /* stream release.
@@ -48,6 +48,10 @@ typedef struct stream_jpxd_state_s
 
 	gs_jpx_cs colorspace;	/* requested output colorspace */
     bool alpha; /* return opacity channel */
+    int reduce; /* resolution levels that may be discarded */
+    float region[4]; /* part of the image to decode, as fractions */
+                     /* (x0, y0, x1, y1) from the top left; empty = all */
+    int threads; /* number of threads to decode the code-blocks in */
 
     unsigned char *inbuf;	/* input data buffer */
     unsigned long inbuf_size;
@@ -20,6 +20,10 @@
 #include "strimpl.h"
 #include "spdiffx.h"
 
+#ifdef HAVE_SSE2
+#include "spredsse2.h"
+#endif
+
 /* ------ PixelDifferenceEncode/Decode ------ */
 
 private_st_PDiff_state();
@@ -83,6 +87,31 @@ s_PDiffD_init(stream_state * st)
     return 0;
 }
 
+#ifdef HAVE_SSE2
+/*
+ * Decode whole blocks of 8-bit samples with 1, 3 or 4 colors with SSE2,
+ * starting from the previous pixel in prev[], and leave the last decoded
+ * pixel there.  Return the number of bytes done; the caller does the
+ * rest (fewer than 16 bytes).
+ */
+static uint
+s_PDiffD_process8_sse2(byte *q, const byte *p, uint count, int colors,
+                       uint *prev)
+{
+    byte last[4];
+    int ci;
+    uint done;
+
+    for (ci = 0; ci < colors; ++ci)
+        last[ci] = (byte)prev[ci];
+    done = s_pred_running_sum_sse2(q, p, last, count, colors);
+    if (done != 0)
+        for (ci = 0; ci < colors; ++ci)
+            prev[ci] = q[done - colors + ci];
+    return done;
+}
+#endif
+
 /* Process a buffer.  Note that this handles both Encode and Decode. */
 static int
 s_PDiff_process(stream_state * st, stream_cursor_read * pr,
@@ -374,6 +403,19 @@ row:
 
 #define ENCODE8(s, d) (q[d] = p[d] - s, s = p[d])
 #define DECODE8(s, d) q[d] = s += p[d]
+#ifdef HAVE_SSE2
+#  define DECODE8_SSE2(n)\
+  BEGIN\
+    uint done;\
+\
+    ss->prev[0] = s0;\
+    done = s_PDiffD_process8_sse2(q + 1, p + 1, count, n, ss->prev);\
+    p += done, q += done, count -= done;\
+    s0 = ss->prev[0];\
+  END
+#else
+#  define DECODE8_SSE2(n) DO_NOTHING
+#endif
 
         case cEncode + cBits8 + 0:
         case cEncode + cBits8 + 2:
@@ -409,6 +451,7 @@ row:
             break;
 
         case cDecode + cBits8 + 1:
+            DECODE8_SSE2(1);
             LOOP_BY(1, DECODE8(s0, 0));
             break;
 
@@ -421,7 +464,9 @@ row:
             goto enc8;
         }
 
-        case cDecode + cBits8 + 3: {
+        case cDecode + cBits8 + 3:
+            DECODE8_SSE2(3);
+        {
             uint s1 = ss->prev[1], s2 = ss->prev[2];
 
             LOOP_BY(3, (DECODE8(s0, -2), DECODE8(s1, -1),
@@ -439,7 +484,9 @@ row:
             goto enc8;
         } break;
 
-        case cDecode + cBits8 + 4: {
+        case cDecode + cBits8 + 4:
+            DECODE8_SSE2(4);
+        {
             uint s1 = ss->prev[1], s2 = ss->prev[2], s3 = ss->prev[3];
 
             LOOP_BY(4, (DECODE8(s0, -3), DECODE8(s1, -2),
@@ -450,6 +497,7 @@ row:
 
 #undef ENCODE8
 #undef DECODE8
+#undef DECODE8_SSE2
 
             /* 16 bits per component */
 
@@ -19,6 +19,10 @@
 #include "strimpl.h"
 #include "spngpx.h"
 
+#ifdef HAVE_SSE2
+#include "spredsse2.h"
+#endif
+
 /* ------ PNGPredictorEncode/Decode ------ */
 
 private_st_PNGP_state();
@@ -115,6 +119,95 @@ s_PNGP_release(stream_state *st)
         gs_free_object(st->memory, ss->prev_row, "PNGPredictor prev row");
 }
 
+#ifdef HAVE_SSE2
+
+/*
+ * SSE2 versions of the decoding loops for the common pixel sizes (1, 3
+ * and 4 bytes, i.e. 8-bit gray, RGB and CMYK or RGBA).  Each returns the
+ * number of bytes it has done; s_pngp_process does the rest (at most a
+ * few bytes at the end of the buffer) with the ordinary loops.  Sub is
+ * s_pred_running_sum_sse2 in spredsse2.h, which we share with the TIFF
+ * predictor.
+ *
+ * Up has no dependencies between bytes in a row, and is done 16 bytes
+ * at a time.  Average and Paeth depend on the pixel just decoded, so we
+ * can only do one pixel at a time, but we do all the bytes of the pixel
+ * at once.  These are inline, and called with a constant bpp, so that
+ * the compiler makes a copy of each for each pixel size.
+ */
+
+static uint
+pngp_decode_up_sse2(byte *q, const byte *p, const byte *up, uint count)
+{
+    uint done = 0;
+
+    for (; count - done >= 16; done += 16)
+        _mm_storeu_si128((__m128i *)(q + done),
+            _mm_add_epi8(_mm_loadu_si128((const __m128i *)(p + done)),
+                         _mm_loadu_si128((const __m128i *)(up + done))));
+    return done;
+}
+
+static inline uint
+pngp_decode_average_sse2(byte *q, const byte *p, const byte *dprev,
+                         const byte *up, uint count, int bpp)
+{
+    const __m128i one = _mm_set1_epi8(1);
+    __m128i a = s_pred_load(dprev, bpp), b;
+    uint done = 0;
+
+    for (; count - done >= bpp; done += bpp) {
+        b = s_pred_load(up + done, bpp);
+        /* (a + b) >> 1, from the rounded average. */
+        b = _mm_sub_epi8(_mm_avg_epu8(a, b),
+                         _mm_and_si128(_mm_xor_si128(a, b), one));
+        a = _mm_add_epi8(s_pred_load(p + done, bpp), b);
+        s_pred_store(q + done, a, bpp);
+    }
+    return done;
+}
+
+static inline uint
+pngp_decode_paeth_sse2(byte *q, const byte *p, const byte *dprev,
+                       const byte *upprev, const byte *up, uint count,
+                       int bpp)
+{
+    const __m128i zero = _mm_setzero_si128();
+    /* Work in 16 bits, so that the differences can't overflow. */
+    __m128i a = _mm_unpacklo_epi8(s_pred_load(dprev, bpp), zero);
+    __m128i c = _mm_unpacklo_epi8(s_pred_load(upprev, bpp), zero);
+    __m128i b, pa, pb, pc, smallest, nearest;
+    uint done = 0;
+
+    for (; count - done >= bpp; done += bpp) {
+        b = _mm_unpacklo_epi8(s_pred_load(up + done, bpp), zero);
+        /* As in paeth_predictor: pa = |b - c|, pb = |a - c|, */
+        /* pc = |a + b - 2c|. */
+        pa = _mm_sub_epi16(b, c);
+        pb = _mm_sub_epi16(a, c);
+        pc = _mm_add_epi16(pa, pb);
+        pa = _mm_max_epi16(pa, _mm_sub_epi16(zero, pa));
+        pb = _mm_max_epi16(pb, _mm_sub_epi16(zero, pb));
+        pc = _mm_max_epi16(pc, _mm_sub_epi16(zero, pc));
+        smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+        /* a if pa is smallest, else b if pb is, else c. */
+        pa = _mm_cmpeq_epi16(pa, smallest);
+        pb = _mm_cmpeq_epi16(pb, smallest);
+        nearest = _mm_or_si128(_mm_and_si128(pb, b),
+                               _mm_andnot_si128(pb, c));
+        nearest = _mm_or_si128(_mm_and_si128(pa, a),
+                               _mm_andnot_si128(pa, nearest));
+        a = _mm_add_epi8(s_pred_load(p + done, bpp),
+                         _mm_packus_epi16(nearest, nearest));
+        s_pred_store(q + done, a, bpp);
+        a = _mm_unpacklo_epi8(a, zero);
+        c = b;
+    }
+    return done;
+}
+
+#endif /* HAVE_SSE2 */
+
 /*
  * Process a partial buffer.  We pass in current and previous pointers
  * to both the current and preceding scan line.  Note that dprev is
@@ -142,6 +235,10 @@ s_pngp_process(stream_state * st, stream_cursor_write * pw,
     stream_PNGP_state *const ss = (stream_PNGP_state *) st;
     byte *q = pw->ptr + 1;
     const byte *p = pr->ptr + 1;
+#ifdef HAVE_SSE2
+    int bpp = ss->bpp;
+    uint done;
+#endif
 
     pr->ptr += count;
     pw->ptr += count;
@@ -156,6 +253,12 @@ s_pngp_process(stream_state * st, stream_cursor_write * pw,
                 *q = (byte) (*p - *dprev);
             break;
         case cDecode + cSub:
+#ifdef HAVE_SSE2
+            if (bpp == 1 || bpp == 3 || bpp == 4) {
+                done = s_pred_running_sum_sse2(q, p, dprev, count, bpp);
+                q += done, dprev += done, p += done, count -= done;
+            }
+#endif
             for (; count; ++q, ++dprev, ++p, --count)
                 *q = (byte) (*p + *dprev);
             break;
@@ -164,6 +267,10 @@ s_pngp_process(stream_state * st, stream_cursor_write * pw,
                 *q = (byte) (*p - *up);
             break;
         case cDecode + cUp:
+#ifdef HAVE_SSE2
+            done = pngp_decode_up_sse2(q, p, up, count);
+            q += done, up += done, p += done, count -= done;
+#endif
             for (; count; ++q, ++up, ++p, --count)
                 *q = (byte) (*p + *up);
             break;
@@ -172,6 +279,15 @@ s_pngp_process(stream_state * st, stream_cursor_write * pw,
                 *q = (byte) (*p - arith_rshift_1((int)*dprev + (int)*up));
             break;
         case cDecode + cAverage:
+#ifdef HAVE_SSE2
+            if (bpp == 3 || bpp == 4) {
+                done = (bpp == 3 ?
+                        pngp_decode_average_sse2(q, p, dprev, up, count, 3) :
+                        pngp_decode_average_sse2(q, p, dprev, up, count, 4));
+                q += done, dprev += done, up += done, p += done;
+                count -= done;
+            }
+#endif
             for (; count; ++q, ++dprev, ++up, ++p, --count)
                 *q = (byte) (*p + arith_rshift_1((int)*dprev + (int)*up));
             break;
@@ -180,6 +296,17 @@ s_pngp_process(stream_state * st, stream_cursor_write * pw,
                 *q = (byte) (*p - paeth_predictor(*dprev, *up, *upprev));
             break;
         case cDecode + cPaeth:
+#ifdef HAVE_SSE2
+            if (bpp == 3 || bpp == 4) {
+                done = (bpp == 3 ?
+                        pngp_decode_paeth_sse2(q, p, dprev, upprev, up,
+                                               count, 3) :
+                        pngp_decode_paeth_sse2(q, p, dprev, upprev, up,
+                                               count, 4));
+                q += done, dprev += done, up += done, upprev += done;
+                p += done, count -= done;
+            }
+#endif
             for (; count; ++q, ++dprev, ++up, ++upprev, ++p, --count)
                 *q = (byte) (*p + paeth_predictor(*dprev, *up, *upprev));
             break;
@@ -0,0 +1,144 @@
+/* Copyright (C) 2001-2012 Artifex Software, Inc.
+   All Rights Reserved.
+
+   This software is provided AS-IS with no warranty, either express or
+   implied.
+
+   This software is distributed under license and may not be copied,
+   modified or distributed except as expressly authorized under the terms
+   of the license contained in the file LICENSE in this distribution.
+
+   Refer to licensing information at http://www.artifex.com or contact
+   Artifex Software, Inc.,  7 Mt. Lassen Drive - Suite A-134, San Rafael,
+   CA  94903, U.S.A., +1(415)492-9861, for further information.
+*/
+
+
+/* SSE2 pixel predictor helpers for the PNG and TIFF predictor filters */
+/* Requires memory_.h, stdpre.h; only include #ifdef HAVE_SSE2 */
+
+#ifndef spredsse2_INCLUDED
+#  define spredsse2_INCLUDED
+
+#include <emmintrin.h>
+
+/*
+ * These handle pixels of 1, 3 or 4 bytes, i.e. 8-bit gray, RGB and CMYK
+ * or RGBA.  The shift counts of _mm_slli_si128 and _mm_srli_si128 must
+ * be constants, so the functions switch on the pixel size instead of
+ * computing the shifts.
+ */
+
+/*
+ * Load or store one pixel in the low bytes of a vector.  We build with
+ * -fno-builtin, so we assemble the bytes ourselves rather than using
+ * memcpy; the compiler turns this into single loads and stores.
+ */
+static inline __m128i
+s_pred_load(const byte *p, int bpp)
+{
+    uint v = p[0];
+
+    if (bpp > 1)
+        v |= (p[1] << 8) | (p[2] << 16);
+    if (bpp > 3)
+        v |= (uint)p[3] << 24;
+    return _mm_cvtsi32_si128((int)v);
+}
+static inline void
+s_pred_store(byte *q, __m128i x, int bpp)
+{
+    uint v = (uint)_mm_cvtsi128_si32(x);
+
+    q[0] = (byte)v;
+    if (bpp > 1)
+        q[1] = (byte)(v >> 8), q[2] = (byte)(v >> 16);
+    if (bpp > 3)
+        q[3] = (byte)(v >> 24);
+}
+
+/* Replicate a pixel in the low bytes (the rest 0) across a vector. */
+static inline __m128i
+s_pred_replicate(__m128i x, int bpp)
+{
+    switch (bpp) {
+        case 1:
+            x = _mm_unpacklo_epi8(x, x);
+            x = _mm_shufflelo_epi16(x, 0);
+            return _mm_shuffle_epi32(x, 0);
+        case 3:
+            x = _mm_or_si128(x, _mm_slli_si128(x, 3));
+            x = _mm_or_si128(x, _mm_slli_si128(x, 6));
+            return _mm_or_si128(x, _mm_slli_si128(x, 12));
+        default:		/* 4 */
+            return _mm_shuffle_epi32(x, 0);
+    }
+}
+
+/* Replicate the last pixel of a block of 16 (15 for bpp = 3) bytes. */
+static inline __m128i
+s_pred_last_pixel(__m128i x, int bpp)
+{
+    switch (bpp) {
+        case 1:
+            return s_pred_replicate(_mm_srli_si128(x, 15), 1);
+        case 3:
+            return s_pred_replicate(_mm_srli_si128(_mm_slli_si128(x, 1), 13),
+                                    3);
+        default:		/* 4 */
+            return _mm_shuffle_epi32(x, 0xff);
+    }
+}
+
+/* Add each pixel of a block to all the following ones. */
+static inline __m128i
+s_pred_block_sum(__m128i x, int bpp)
+{
+    switch (bpp) {
+        case 1:
+            x = _mm_add_epi8(x, _mm_slli_si128(x, 1));
+            x = _mm_add_epi8(x, _mm_slli_si128(x, 2));
+            x = _mm_add_epi8(x, _mm_slli_si128(x, 4));
+            return _mm_add_epi8(x, _mm_slli_si128(x, 8));
+        case 3:
+            x = _mm_add_epi8(x, _mm_slli_si128(x, 3));
+            x = _mm_add_epi8(x, _mm_slli_si128(x, 6));
+            return _mm_add_epi8(x, _mm_slli_si128(x, 12));
+        default:		/* 4 */
+            x = _mm_add_epi8(x, _mm_slli_si128(x, 4));
+            return _mm_add_epi8(x, _mm_slli_si128(x, 8));
+    }
+}
+
+/*
+ * Undo horizontal differencing (PNG Sub, TIFF predictor 2):
+ * q[i] = p[i] + q[i - bpp], where the pixel before q[0] is at dprev.
+ * We sum each block of 16 bytes (15 for bpp = 3) in log2(pixels)
+ * shift-and-add steps, then add the last pixel of the previous block.
+ * Return the number of bytes done, a multiple of bpp; the caller does the
+ * rest (fewer than 16 bytes) itself.
+ */
+static uint
+s_pred_running_sum_sse2(byte *q, const byte *p, const byte *dprev,
+                        uint count, int bpp)
+{
+    int step = (bpp == 3 ? 15 : 16);
+    __m128i last, x;
+    uint done = 0;
+
+    if (count < 16)
+        return 0;
+    last = s_pred_replicate(s_pred_load(dprev, bpp), bpp);
+    for (; count - done >= 16; done += step) {
+        x = s_pred_block_sum(_mm_loadu_si128((const __m128i *)(p + done)),
+                             bpp);
+        /* For bpp = 3, the 16th byte is wrong, but it is in the */
+        /* buffer, and the next block or the caller replaces it. */
+        _mm_storeu_si128((__m128i *)(q + done), _mm_add_epi8(x, last));
+        /* Keep the blocks independent except for this one addition. */
+        last = _mm_add_epi8(last, s_pred_last_pixel(x, bpp));
+    }
+    return done;
+}
+
+#endif /* spredsse2_INCLUDED */
@@ -181,6 +181,8 @@ struct stream_s {
     /* Clients must only set the following through sread_subfile. */
     long file_offset;		/* starting point in file (reading) */
     long file_limit;		/* ending point in file (reading) */
+    long file_pos;		/* OS position of a file descriptor (reading), */
+                                /* so that reading needn't ask for it */
 };
 
 /* The descriptor is only public for subclassing. */
@@ -385,6 +387,17 @@ void sread_file(stream *, FILE *, byte *, uint),
 /* Confine reading to a subfile.  This is primarily for reusable streams. */
 int sread_subfile(stream *s, long start, long length);
 
+/*
+ * Ask the OS to read ahead in an input file: pos is the file position
+ * just after reading count bytes, or the position of a newly opened file
+ * with count = 0.  This is a no-op without HAVE_POSIX_FADVISE.
+ */
+#ifdef HAVE_POSIX_FADVISE
+void file_read_ahead(int fd, long pos, uint count);
+#else
+#  define file_read_ahead(fd, pos, count) DO_NOTHING
+#endif
+
 /* Set the file name of a stream, copying the name. */
 /* Return <0 if the copy could not be allocated. */
 int ssetfilename(stream *, const byte *, uint);
@@ -0,0 +1,320 @@
+/* Copyright (C) 2001-2012 Artifex Software, Inc.
+   All Rights Reserved.
+
+   This software is provided AS-IS with no warranty, either express or
+   implied.
+
+   This software is distributed under license and may not be copied,
+   modified or distributed except as expressly authorized under the terms
+   of the license contained in the file LICENSE in this distribution.
+
+   Refer to licensing information at http://www.artifex.com or contact
+   Artifex Software, Inc.,  7 Mt. Lassen Drive - Suite A-134, San Rafael,
+   CA  94903, U.S.A., +1(415)492-9861, for further information.
+*/
+
+
+/* Faster replacement for zlib's inflate_fast */
+
+/*
+ * This file takes the place of zlib's inffast.c (see ZINFFAST in zlib.mak):
+ * it is compiled with the zlib sources, and inflate() calls it for the bulk
+ * of the decoding, exactly as it calls the stock version.  The entry and
+ * exit conditions are those documented in zlib/inffast.c.  The algorithm
+ * is the same too; the differences are in how the bits and bytes move:
+ *
+ *	- Where unsigned long has 64 bits, the bit buffer is refilled only
+ *	once per literal or length/distance pair, with a single 8-byte load
+ *	when at least 8 bytes of input remain.  One refill leaves at least
+ *	56 bits, which covers the longest pair (48 bits).  With 32-bit longs
+ *	we refill a byte at a time as needed, as zlib does.
+ *
+ *	- Matches that don't overlap themselves by less than 16 (or 8)
+ *	bytes are copied in 16 (or 8) byte chunks; the rest byte by byte.
+ *	The chunks are structure assignments, which the compiler turns into
+ *	wide unaligned loads and stores; nothing is written beyond the end
+ *	of the match.
+ *
+ * Matches that reach back into the sliding window are copied as zlib
+ * copies them: they are rare once the output buffer is reasonably large.
+ */
+
+#include "zutil.h"
+#include "inftrees.h"
+#include "inflate.h"
+#include "inffast.h"
+#include <limits.h>
+
+#if ULONG_MAX > 0xffffffffUL
+#  define WIDE_HOLD 1
+/* Load 8 bytes, least significant first. */
+#  define LOAD_LE64(p)\
+    ((unsigned long)(p)[0] | ((unsigned long)(p)[1] << 8) |\
+     ((unsigned long)(p)[2] << 16) | ((unsigned long)(p)[3] << 24) |\
+     ((unsigned long)(p)[4] << 32) | ((unsigned long)(p)[5] << 40) |\
+     ((unsigned long)(p)[6] << 48) | ((unsigned long)(p)[7] << 56))
+/* The refill at the top of the loop is enough for a whole pair. */
+#  define NEEDBITS(n) DO_NOTHING
+#else
+#  define WIDE_HOLD 0
+#  define NEEDBITS(n)\
+    while (bits < (unsigned)(n)) {\
+        hold += (unsigned long)(*in++) << bits;\
+        bits += 8;\
+    }
+#endif
+
+#ifndef DO_NOTHING
+#  define DO_NOTHING do {} while (0)
+#endif
+
+typedef struct { unsigned char b[16]; } inflate_chunk16;
+typedef struct { unsigned char b[8]; } inflate_chunk8;
+
+void ZLIB_INTERNAL
+inflate_fast(z_streamp strm, unsigned start)
+{
+    struct inflate_state FAR *state = (struct inflate_state FAR *)strm->state;
+    unsigned char FAR *in = strm->next_in;
+    unsigned char FAR *in_end = in + strm->avail_in;
+    unsigned char FAR *out = strm->next_out;
+    unsigned char FAR *out_end = out + strm->avail_out;
+    /* inflate()'s initial strm->next_out */
+    unsigned char FAR *beg = out - (start - strm->avail_out);
+    /* while out < end, there is room for the longest match */
+    unsigned char FAR *end = out_end - 257;
+#ifdef INFLATE_STRICT
+    unsigned dmax = state->dmax;
+#endif
+    unsigned wsize = state->wsize;
+    unsigned whave = state->whave;
+    unsigned wnext = state->wnext;
+    unsigned char FAR *window = state->window;
+    unsigned long hold = state->hold;
+    unsigned bits = state->bits;
+    code const FAR *lcode = state->lencode;
+    code const FAR *dcode = state->distcode;
+    unsigned lmask = (1U << state->lenbits) - 1;
+    unsigned dmask = (1U << state->distbits) - 1;
+    code here;                  /* retrieved table entry */
+    unsigned op;                /* code bits, operation, extra bits, or */
+                                /*  window position, window bytes to copy */
+    unsigned len;               /* match length, unused bytes */
+    unsigned dist;              /* match distance */
+    unsigned char FAR *from;    /* where to copy match from */
+
+    /*
+     * inflate() only calls us with at least 6 bytes of input and 258 bytes
+     * of output space, so the first pass through the loop always decodes
+     * something.
+     */
+    while (out < end) {
+#if WIDE_HOLD
+        if (in_end - in >= 8) {
+            /*
+             * Load 8 bytes and keep as many whole bytes as fit.  The bits
+             * above the new count are the start of the next byte, so
+             * or-ing it in again later does no harm.
+             */
+            hold |= LOAD_LE64(in) << bits;
+            in += (63 - bits) >> 3;
+            bits |= 56;
+        } else {
+            while (bits < 56 && in < in_end) {
+                hold |= (unsigned long)(*in++) << bits;
+                bits += 8;
+            }
+            if (bits < 48)
+                break;
+        }
+#else
+        if (in_end - in < 6)
+            break;
+        NEEDBITS(15);
+#endif
+        here = lcode[hold & lmask];
+      dolen:
+        op = (unsigned)(here.bits);
+        hold >>= op;
+        bits -= op;
+        op = (unsigned)(here.op);
+        if (op == 0) {                          /* literal */
+            Tracevv((stderr, here.val >= 0x20 && here.val < 0x7f ?
+                    "inflate:         literal '%c'\n" :
+                    "inflate:         literal 0x%02x\n", here.val));
+            *out++ = (unsigned char)(here.val);
+        }
+        else if (op & 16) {                     /* length base */
+            len = (unsigned)(here.val);
+            op &= 15;                           /* number of extra bits */
+            if (op) {
+                NEEDBITS(op);
+                len += (unsigned)hold & ((1U << op) - 1);
+                hold >>= op;
+                bits -= op;
+            }
+            Tracevv((stderr, "inflate:         length %u\n", len));
+            NEEDBITS(15);
+            here = dcode[hold & dmask];
+          dodist:
+            op = (unsigned)(here.bits);
+            hold >>= op;
+            bits -= op;
+            op = (unsigned)(here.op);
+            if (op & 16) {                      /* distance base */
+                dist = (unsigned)(here.val);
+                op &= 15;                       /* number of extra bits */
+                NEEDBITS(op);
+                dist += (unsigned)hold & ((1U << op) - 1);
+#ifdef INFLATE_STRICT
+                if (dist > dmax) {
+                    strm->msg = (char *)"invalid distance too far back";
+                    state->mode = BAD;
+                    break;
+                }
+#endif
+                hold >>= op;
+                bits -= op;
+                Tracevv((stderr, "inflate:         distance %u\n", dist));
+                op = (unsigned)(out - beg);     /* max distance in output */
+                if (dist > op) {                /* see if copy from window */
+                    op = dist - op;             /* distance back in window */
+                    if (op > whave) {
+                        /* We don't build with */
+                        /* INFLATE_ALLOW_INVALID_DISTANCE_TOOFAR_ARRR. */
+                        strm->msg = (char *)"invalid distance too far back";
+                        state->mode = BAD;
+                        break;
+                    }
+                    from = window;
+                    if (wnext == 0) {           /* very common case */
+                        from += wsize - op;
+                        if (op < len) {         /* some from window */
+                            len -= op;
+                            do {
+                                *out++ = *from++;
+                            } while (--op);
+                            from = out - dist;  /* rest from output */
+                        }
+                    }
+                    else if (wnext < op) {      /* wrap around window */
+                        from += wsize + wnext - op;
+                        op -= wnext;
+                        if (op < len) {         /* some from end of window */
+                            len -= op;
+                            do {
+                                *out++ = *from++;
+                            } while (--op);
+                            from = window;
+                            if (wnext < len) {  /* some from start of window */
+                                op = wnext;
+                                len -= op;
+                                do {
+                                    *out++ = *from++;
+                                } while (--op);
+                                from = out - dist;      /* rest from output */
+                            }
+                        }
+                    }
+                    else {                      /* contiguous in window */
+                        from += wnext - op;
+                        if (op < len) {         /* some from window */
+                            len -= op;
+                            do {
+                                *out++ = *from++;
+                            } while (--op);
+                            from = out - dist;  /* rest from output */
+                        }
+                    }
+                    while (len > 2) {
+                        *out++ = *from++;
+                        *out++ = *from++;
+                        *out++ = *from++;
+                        len -= 3;
+                    }
+                    if (len) {
+                        *out++ = *from++;
+                        if (len > 1)
+                            *out++ = *from++;
+                    }
+                }
+                else {
+                    from = out - dist;          /* copy direct from output */
+                    if (dist < 16 && len >= 32) {
+                        /*
+                         * A run: the match repeats its first dist bytes.
+                         * Copy whole repeats a byte at a time until they
+                         * add up to 16 bytes or more; from then on we can
+                         * copy from that far back, which is the same
+                         * data, in chunks.
+                         */
+                        op = dist * ((dist + 15) / dist);
+                        len -= op - dist;
+                        for (dist = op - dist; dist; --dist)
+                            *out++ = *from++;
+                        dist = op;
+                        from = out - dist;
+                    }
+                    if (dist >= 16) {
+                        for (; len >= 16; len -= 16, out += 16, from += 16)
+                            *(inflate_chunk16 *)out =
+                                *(const inflate_chunk16 *)from;
+                    } else if (dist >= 8) {
+                        for (; len >= 8; len -= 8, out += 8, from += 8)
+                            *(inflate_chunk8 *)out =
+                                *(const inflate_chunk8 *)from;
+                    }
+                    while (len > 2) {
+                        *out++ = *from++;
+                        *out++ = *from++;
+                        *out++ = *from++;
+                        len -= 3;
+                    }
+                    if (len) {
+                        *out++ = *from++;
+                        if (len > 1)
+                            *out++ = *from++;
+                    }
+                }
+            }
+            else if ((op & 64) == 0) {          /* 2nd level distance code */
+                here = dcode[here.val + (hold & ((1U << op) - 1))];
+                goto dodist;
+            }
+            else {
+                strm->msg = (char *)"invalid distance code";
+                state->mode = BAD;
+                break;
+            }
+        }
+        else if ((op & 64) == 0) {              /* 2nd level length code */
+            here = lcode[here.val + (hold & ((1U << op) - 1))];
+            goto dolen;
+        }
+        else if (op & 32) {                     /* end-of-block */
+            Tracevv((stderr, "inflate:         end of block\n"));
+            state->mode = TYPE;
+            break;
+        }
+        else {
+            strm->msg = (char *)"invalid literal/length code";
+            state->mode = BAD;
+            break;
+        }
+    }
+
+    /* Return the whole bytes we haven't used; we read them all in this */
+    /* call, since on entry bits < 8. */
+    len = bits >> 3;
+    in -= len;
+    bits -= len << 3;
+    hold &= (1UL << bits) - 1;
+
+    /* update state and return */
+    strm->next_in = in;
+    strm->avail_in = (unsigned)(in_end - in);
+    strm->next_out = out;
+    strm->avail_out = (unsigned)(out_end - out);
+    state->hold = hold;
+    state->bits = bits;
+}
@@ -136,8 +136,13 @@ $(ZGEN)zlibd_1.dev : $(TOP_MAKEFILES) $(ZLIB_MAK) $(ECHOGS_XE)
 zlibd1_=$(ZOBJ)infblock.$(OBJ) $(ZOBJ)infcodes.$(OBJ) $(ZOBJ)inffast.$(OBJ)
 zlibd2_=$(ZOBJ)inflate.$(OBJ) $(ZOBJ)inftrees.$(OBJ) $(ZOBJ)infutil.$(OBJ) $(ZOBJ)crc32.$(OBJ)
 
+# ZINFFAST selects the inner decoding loop: szinffast (the default) is our
+# faster replacement for zlib's inflate_fast, with a 64-bit bit buffer and
+# chunked match copies; inffast is the one that comes with zlib.
+ZINFFAST=szinffast
+
 # shorter list of files for zlib 1.2.x
-zlibd_=$(ZOBJ)inffast.$(OBJ) $(ZOBJ)inflate.$(OBJ) $(ZOBJ)inftrees.$(OBJ) $(ZOBJ)uncompr.$(OBJ)
+zlibd_=$(ZOBJ)$(ZINFFAST).$(OBJ) $(ZOBJ)inflate.$(OBJ) $(ZOBJ)inftrees.$(OBJ) $(ZOBJ)uncompr.$(OBJ)
 
 
 $(ZGEN)zlibd_0.dev : $(ZLIB_MAK) $(ECHOGS_XE) $(ZGEN)zlibc.dev $(zlibd_)
@@ -153,6 +158,10 @@ $(ZOBJ)infcodes.$(OBJ) : $(ZSRC)infcodes.c $(ZDEP)
 $(ZOBJ)inffast.$(OBJ) : $(ZSRC)inffast.c $(ZDEP)
 	$(ZCC) $(ZO_)inffast.$(OBJ) $(C_) $(ZSRC)inffast.c
 
+# szinffast.c is ours, but it uses zlib's internal headers.
+$(ZOBJ)szinffast.$(OBJ) : $(GLSRC)szinffast.c $(ZDEP)
+	$(ZCC) $(ZO_)szinffast.$(OBJ) $(C_) $(GLSRC)szinffast.c
+
 $(ZOBJ)inflate.$(OBJ) : $(ZSRC)inflate.c $(ZDEP)
 	$(ZCC) $(ZO_)inflate.$(OBJ) $(C_) $(ZSRC)inflate.c
 
@@ -51,6 +51,20 @@ jbig2_generic_stats_size(Jbig2Ctx *ctx, int template)
 }
 
 
+/* 6.2.5.7 3b: a typical row is a copy of the one above it */
+static void
+copy_prev_row(Jbig2Image *image, int row)
+{
+  if (!row) {
+    /* no previous row */
+    memset( image->data, 0, image->stride );
+  } else {
+    /* duplicate data from the previous row */
+    uint8_t *src = image->data + (row - 1) * image->stride;
+    memcpy( src + image->stride, src, image->stride );
+  }
+}
+
 static int
 jbig2_decode_generic_template0(Jbig2Ctx *ctx,
 			       Jbig2Segment *segment,
@@ -64,6 +78,7 @@ jbig2_decode_generic_template0(Jbig2Ctx *ctx,
   const int rowstride = image->stride;
   int x, y;
   byte *gbreg_line = (byte *)image->data;
+  int LTP = 0;
 
   /* todo: currently we only handle the nominal gbat location */
 
@@ -78,6 +93,18 @@ jbig2_decode_generic_template0(Jbig2Ctx *ctx,
       uint32_t line_m2;
       int padded_width = (GBW + 7) & -8;
 
+      /* 6.2.5.7 3b */
+      if (params->TPGDON)
+        {
+          LTP ^= jbig2_arith_decode(as, &GB_stats[0x9B25]);
+          if (LTP)
+            {
+              copy_prev_row(image, y);
+              gbreg_line += rowstride;
+              continue;
+            }
+        }
+
       line_m1 = (y >= 1) ? gbreg_line[-rowstride] : 0;
       line_m2 = (y >= 2) ? gbreg_line[-(rowstride << 1)] << 6 : 0;
       CONTEXT = (line_m1 & 0x7f0) | (line_m2 & 0xf800);
@@ -119,52 +146,6 @@ jbig2_decode_generic_template0(Jbig2Ctx *ctx,
   return 0;
 }
 
-static int
-jbig2_decode_generic_template0_unopt(Jbig2Ctx *ctx,
-                               Jbig2Segment *segment,
-                               const Jbig2GenericRegionParams *params,
-                               Jbig2ArithState *as,
-                               Jbig2Image *image,
-                               Jbig2ArithCx *GB_stats)
-{
-  const int GBW = image->width;
-  const int GBH = image->height;
-  uint32_t CONTEXT;
-  int x,y;
-  bool bit;
-
-  /* this version is generic and easy to understand, but very slow */
-
-  for (y = 0; y < GBH; y++) {
-    for (x = 0; x < GBW; x++) {
-      CONTEXT = 0;
-      CONTEXT |= jbig2_image_get_pixel(image, x - 1, y) << 0;
-      CONTEXT |= jbig2_image_get_pixel(image, x - 2, y) << 1;
-      CONTEXT |= jbig2_image_get_pixel(image, x - 3, y) << 2;
-      CONTEXT |= jbig2_image_get_pixel(image, x - 4, y) << 3;
-      CONTEXT |= jbig2_image_get_pixel(image, x + params->gbat[0],
-	y + params->gbat[1]) << 4;
-      CONTEXT |= jbig2_image_get_pixel(image, x + 2, y - 1) << 5;
-      CONTEXT |= jbig2_image_get_pixel(image, x + 1, y - 1) << 6;
-      CONTEXT |= jbig2_image_get_pixel(image, x + 0, y - 1) << 7;
-      CONTEXT |= jbig2_image_get_pixel(image, x - 1, y - 1) << 8;
-      CONTEXT |= jbig2_image_get_pixel(image, x - 2, y - 1) << 9;
-      CONTEXT |= jbig2_image_get_pixel(image, x + params->gbat[2],
-	y + params->gbat[3]) << 10;
-      CONTEXT |= jbig2_image_get_pixel(image, x + params->gbat[4],
-	y + params->gbat[5]) << 11;
-      CONTEXT |= jbig2_image_get_pixel(image, x + 1, y - 2) << 12;
-      CONTEXT |= jbig2_image_get_pixel(image, x + 0, y - 2) << 13;
-      CONTEXT |= jbig2_image_get_pixel(image, x - 1, y - 2) << 14;
-      CONTEXT |= jbig2_image_get_pixel(image, x + params->gbat[6],
-	y + params->gbat[7]) << 15;
-      bit = jbig2_arith_decode(as, &GB_stats[CONTEXT]);
-      jbig2_image_set_pixel(image, x, y, bit);
-    }
-  }
-  return 0;
-}
-
 static int
 jbig2_decode_generic_template1(Jbig2Ctx *ctx,
 			       Jbig2Segment *segment,
@@ -178,6 +159,7 @@ jbig2_decode_generic_template1(Jbig2Ctx *ctx,
   const int rowstride = image->stride;
   int x, y;
   byte *gbreg_line = (byte *)image->data;
+  int LTP = 0;
 
   /* todo: currently we only handle the nominal gbat location */
 
@@ -192,6 +174,18 @@ jbig2_decode_generic_template1(Jbig2Ctx *ctx,
       uint32_t line_m2;
       int padded_width = (GBW + 7) & -8;
 
+      /* 6.2.5.7 3b */
+      if (params->TPGDON)
+        {
+          LTP ^= jbig2_arith_decode(as, &GB_stats[0x0795]);
+          if (LTP)
+            {
+              copy_prev_row(image, y);
+              gbreg_line += rowstride;
+              continue;
+            }
+        }
+
       line_m1 = (y >= 1) ? gbreg_line[-rowstride] : 0;
       line_m2 = (y >= 2) ? gbreg_line[-(rowstride << 1)] << 5 : 0;
       CONTEXT = ((line_m1 >> 1) & 0x1f8) | ((line_m2 >> 1) & 0x1e00);
@@ -246,6 +240,7 @@ jbig2_decode_generic_template2(Jbig2Ctx *ctx,
   const int rowstride = image->stride;
   int x, y;
   byte *gbreg_line = (byte *)image->data;
+  int LTP = 0;
 
   /* todo: currently we only handle the nominal gbat location */
 
@@ -260,6 +255,18 @@ jbig2_decode_generic_template2(Jbig2Ctx *ctx,
       uint32_t line_m2;
       int padded_width = (GBW + 7) & -8;
 
+      /* 6.2.5.7 3b */
+      if (params->TPGDON)
+        {
+          LTP ^= jbig2_arith_decode(as, &GB_stats[0xE5]);
+          if (LTP)
+            {
+              copy_prev_row(image, y);
+              gbreg_line += rowstride;
+              continue;
+            }
+        }
+
       line_m1 = (y >= 1) ? gbreg_line[-rowstride] : 0;
       line_m2 = (y >= 2) ? gbreg_line[-(rowstride << 1)] << 4 : 0;
       CONTEXT = ((line_m1 >> 3) & 0x7c) | ((line_m2 >> 3) & 0x380);
@@ -314,6 +321,7 @@ jbig2_decode_generic_template2a(Jbig2Ctx *ctx,
   const int rowstride = image->stride;
   int x, y;
   byte *gbreg_line = (byte *)image->data;
+  int LTP = 0;
 
   /* This is a special case for GBATX1 = 3, GBATY1 = -1 */
 
@@ -328,6 +336,18 @@ jbig2_decode_generic_template2a(Jbig2Ctx *ctx,
       uint32_t line_m2;
       int padded_width = (GBW + 7) & -8;
 
+      /* 6.2.5.7 3b */
+      if (params->TPGDON)
+        {
+          LTP ^= jbig2_arith_decode(as, &GB_stats[0xE5]);
+          if (LTP)
+            {
+              copy_prev_row(image, y);
+              gbreg_line += rowstride;
+              continue;
+            }
+        }
+
       line_m1 = (y >= 1) ? gbreg_line[-rowstride] : 0;
       line_m2 = (y >= 2) ? gbreg_line[-(rowstride << 1)] << 4 : 0;
       CONTEXT = ((line_m1 >> 3) & 0x78) | ((line_m1 >> 2) & 0x4) | ((line_m2 >> 3) & 0x380);
@@ -370,7 +390,6 @@ jbig2_decode_generic_template2a(Jbig2Ctx *ctx,
   return 0;
 }
 
-#ifdef UNUSED
 static int
 jbig2_decode_generic_template3(Jbig2Ctx *ctx,
 			       Jbig2Segment *segment,
@@ -384,6 +403,7 @@ jbig2_decode_generic_template3(Jbig2Ctx *ctx,
   const int rowstride = image->stride;
   byte *gbreg_line = (byte *)image->data;
   int x, y;
+  int LTP = 0;
 
   /* this routine only handles the nominal AT location */
 
@@ -397,6 +417,18 @@ jbig2_decode_generic_template3(Jbig2Ctx *ctx,
       uint32_t line_m1;
       int padded_width = (GBW + 7) & -8;
 
+      /* 6.2.5.7 3b */
+      if (params->TPGDON)
+        {
+          LTP ^= jbig2_arith_decode(as, &GB_stats[0x0195]);
+          if (LTP)
+            {
+              copy_prev_row(image, y);
+              gbreg_line += rowstride;
+              continue;
+            }
+        }
+
       line_m1 = (y >= 1) ? gbreg_line[-rowstride] : 0;
       CONTEXT = (line_m1 >> 1) & 0x3f0;
 
@@ -419,7 +451,7 @@ jbig2_decode_generic_template3(Jbig2Ctx *ctx,
 	      bit = jbig2_arith_decode(as, &GB_stats[CONTEXT]);
 	      result |= bit << (7 - x_minor);
 	      CONTEXT = ((CONTEXT & 0x1f7) << 1) | bit |
-		((line_m1 >> (10 - x_minor)) & 0x010);
+		((line_m1 >> (8 - x_minor)) & 0x010);
 	    }
 	  gbreg_line[x >> 3] = result;
 	}
@@ -431,60 +463,9 @@ jbig2_decode_generic_template3(Jbig2Ctx *ctx,
 
   return 0;
 }
-#endif
-
-static int
-jbig2_decode_generic_template3_unopt(Jbig2Ctx *ctx,
-                               Jbig2Segment *segment,
-                               const Jbig2GenericRegionParams *params,
-                               Jbig2ArithState *as,
-                               Jbig2Image *image,
-                               Jbig2ArithCx *GB_stats)
-{
-  const int GBW = image->width;
-  const int GBH = image->height;
-  uint32_t CONTEXT;
-  int x,y;
-  bool bit;
-
-  /* this version is generic and easy to understand, but very slow */
-
-  for (y = 0; y < GBH; y++) {
-    for (x = 0; x < GBW; x++) {
-      CONTEXT = 0;
-      CONTEXT |= jbig2_image_get_pixel(image, x - 1, y) << 0;
-      CONTEXT |= jbig2_image_get_pixel(image, x - 2, y) << 1;
-      CONTEXT |= jbig2_image_get_pixel(image, x - 3, y) << 2;
-      CONTEXT |= jbig2_image_get_pixel(image, x - 4, y) << 3;
-      CONTEXT |= jbig2_image_get_pixel(image, x + params->gbat[0],
-	y + params->gbat[1]) << 4;
-      CONTEXT |= jbig2_image_get_pixel(image, x + 1, y - 1) << 5;
-      CONTEXT |= jbig2_image_get_pixel(image, x + 0, y - 1) << 6;
-      CONTEXT |= jbig2_image_get_pixel(image, x - 1, y - 1) << 7;
-      CONTEXT |= jbig2_image_get_pixel(image, x - 2, y - 1) << 8;
-      CONTEXT |= jbig2_image_get_pixel(image, x - 3, y - 1) << 9;
-      bit = jbig2_arith_decode(as, &GB_stats[CONTEXT]);
-      jbig2_image_set_pixel(image, x, y, bit);
-    }
-  }
-  return 0;
-}
-
-static void
-copy_prev_row(Jbig2Image *image, int row)
-{
-  if (!row) {
-    /* no previous row */
-    memset( image->data, 0, image->stride );
-  } else {
-    /* duplicate data from the previous row */
-    uint8_t *src = image->data + (row - 1) * image->stride;
-    memcpy( src + image->stride, src, image->stride );
-  }
-}
 
 static int
-jbig2_decode_generic_template0_TPGDON(Jbig2Ctx *ctx,
+jbig2_decode_generic_template0_unopt(Jbig2Ctx *ctx,
 				Jbig2Segment *segment,
 				const Jbig2GenericRegionParams *params,
 				Jbig2ArithState *as,
@@ -500,7 +481,8 @@ jbig2_decode_generic_template0_TPGDON(Jbig2Ctx *ctx,
 
   for (y = 0; y < GBH; y++)
   {
-    LTP ^= jbig2_arith_decode(as, &GB_stats[0x9B25]);
+    if (params->TPGDON)
+      LTP ^= jbig2_arith_decode(as, &GB_stats[0x9B25]);
     if (!LTP) {
       for (x = 0; x < GBW; x++) {
         CONTEXT  = jbig2_image_get_pixel(image, x - 1, y);
@@ -535,7 +517,7 @@ jbig2_decode_generic_template0_TPGDON(Jbig2Ctx *ctx,
 }
 
 static int
-jbig2_decode_generic_template1_TPGDON(Jbig2Ctx *ctx,
+jbig2_decode_generic_template1_unopt(Jbig2Ctx *ctx,
 				Jbig2Segment *segment,
 				const Jbig2GenericRegionParams *params,
 				Jbig2ArithState *as,
@@ -550,7 +532,8 @@ jbig2_decode_generic_template1_TPGDON(Jbig2Ctx *ctx,
   int LTP = 0;
 
   for (y = 0; y < GBH; y++) {
-    LTP ^= jbig2_arith_decode(as, &GB_stats[0x0795]);
+    if (params->TPGDON)
+      LTP ^= jbig2_arith_decode(as, &GB_stats[0x0795]);
     if (!LTP) {
       for (x = 0; x < GBW; x++) {
         CONTEXT  = jbig2_image_get_pixel(image, x - 1, y);
@@ -579,7 +562,7 @@ jbig2_decode_generic_template1_TPGDON(Jbig2Ctx *ctx,
 }
 
 static int
-jbig2_decode_generic_template2_TPGDON(Jbig2Ctx *ctx,
+jbig2_decode_generic_template2_unopt(Jbig2Ctx *ctx,
 				Jbig2Segment *segment,
 				const Jbig2GenericRegionParams *params,
 				Jbig2ArithState *as,
@@ -594,7 +577,8 @@ jbig2_decode_generic_template2_TPGDON(Jbig2Ctx *ctx,
   int LTP = 0;
 
   for (y = 0; y < GBH; y++) {
-    LTP ^= jbig2_arith_decode(as, &GB_stats[0xE5]);
+    if (params->TPGDON)
+      LTP ^= jbig2_arith_decode(as, &GB_stats[0xE5]);
     if (!LTP) {
       for (x = 0; x < GBW; x++) {
         CONTEXT  = jbig2_image_get_pixel(image, x - 1, y);
@@ -620,7 +604,7 @@ jbig2_decode_generic_template2_TPGDON(Jbig2Ctx *ctx,
 }
 
 static int
-jbig2_decode_generic_template3_TPGDON(Jbig2Ctx *ctx,
+jbig2_decode_generic_template3_unopt(Jbig2Ctx *ctx,
 				Jbig2Segment *segment,
 				const Jbig2GenericRegionParams *params,
 				Jbig2ArithState *as,
@@ -635,7 +619,8 @@ jbig2_decode_generic_template3_TPGDON(Jbig2Ctx *ctx,
   int LTP = 0;
 
   for (y = 0; y < GBH; y++) {
-    LTP ^= jbig2_arith_decode(as, &GB_stats[0x0195]);
+    if (params->TPGDON)
+      LTP ^= jbig2_arith_decode(as, &GB_stats[0x0195]);
     if (!LTP) {
       for (x = 0; x < GBW; x++) {
         CONTEXT  = jbig2_image_get_pixel(image, x - 1, y);
@@ -660,32 +645,6 @@ jbig2_decode_generic_template3_TPGDON(Jbig2Ctx *ctx,
   return 0;
 }
 
-static int
-jbig2_decode_generic_region_TPGDON(Jbig2Ctx *ctx,
-				Jbig2Segment *segment,
-				const Jbig2GenericRegionParams *params,
-				Jbig2ArithState *as,
-				Jbig2Image *image,
-				Jbig2ArithCx *GB_stats)
-{
-  switch (params->GBTEMPLATE) {
-    case 0:
-      return jbig2_decode_generic_template0_TPGDON(ctx, segment,
-			params, as, image, GB_stats);
-    case 1:
-      return jbig2_decode_generic_template1_TPGDON(ctx, segment,
-			params, as, image, GB_stats);
-    case 2:
-      return jbig2_decode_generic_template2_TPGDON(ctx, segment,
-			params, as, image, GB_stats);
-    case 3:
-      return jbig2_decode_generic_template3_TPGDON(ctx, segment,
-			params, as, image, GB_stats);
-  }
-
-  return -1;
-}
-
 /**
  * jbig2_decode_generic_region: Decode a generic region.
  * @ctx: The context for allocation and error reporting.
@@ -713,10 +672,8 @@ jbig2_decode_generic_region(Jbig2Ctx *ctx,
 {
   const int8_t *gbat = params->gbat;
 
-  if (!params->MMR && params->TPGDON)
-     return jbig2_decode_generic_region_TPGDON(ctx, segment, params,
-		as, image, GB_stats);
-
+  /* The optimized routines handle the nominal AT pixel locations, */
+  /* with or without typical prediction. */
   if (!params->MMR && params->GBTEMPLATE == 0) {
     if (gbat[0] == +3 && gbat[1] == -1 &&
         gbat[2] == -3 && gbat[3] == -1 &&
@@ -727,21 +684,28 @@ jbig2_decode_generic_region(Jbig2Ctx *ctx,
     else
       return jbig2_decode_generic_template0_unopt(ctx, segment, params,
                                           as, image, GB_stats);
-  } else if (!params->MMR && params->GBTEMPLATE == 1)
-    return jbig2_decode_generic_template1(ctx, segment, params,
+  } else if (!params->MMR && params->GBTEMPLATE == 1) {
+    if (gbat[0] == +3 && gbat[1] == -1)
+      return jbig2_decode_generic_template1(ctx, segment, params,
 					  as, image, GB_stats);
-  else if (!params->MMR && params->GBTEMPLATE == 2)
+    else
+      return jbig2_decode_generic_template1_unopt(ctx, segment, params,
+					  as, image, GB_stats);
+  } else if (!params->MMR && params->GBTEMPLATE == 2)
     {
-      if (gbat[0] == 3 && gbat[1] == -1)
+      if (gbat[0] == 2 && gbat[1] == -1)
+	return jbig2_decode_generic_template2(ctx, segment, params,
+                                              as, image, GB_stats);
+      else if (gbat[0] == 3 && gbat[1] == -1)
 	return jbig2_decode_generic_template2a(ctx, segment, params,
 					       as, image, GB_stats);
       else
-	return jbig2_decode_generic_template2(ctx, segment, params,
+	return jbig2_decode_generic_template2_unopt(ctx, segment, params,
                                               as, image, GB_stats);
     }
   else if (!params->MMR && params->GBTEMPLATE == 3) {
    if (gbat[0] == 2 && gbat[1] == -1)
-     return jbig2_decode_generic_template3_unopt(ctx, segment, params,
+     return jbig2_decode_generic_template3(ctx, segment, params,
                                          as, image, GB_stats);
    else
      return jbig2_decode_generic_template3_unopt(ctx, segment, params,
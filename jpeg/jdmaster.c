@@ -108,18 +108,22 @@ jpeg_calc_output_dimensions (j_decompress_ptr cinfo)
    * scale up the chroma components via IDCT scaling rather than upsampling.
    * This saves time if the upsampler gets to use 1:1 scaling.
    * Note this code adapts subsampling ratios which are powers of 2.
+   * Ghostscript: only do this when the output is scaled down, so that
+   * full size output is the same as without IDCT scaling.
    */
   for (ci = 0, compptr = cinfo->comp_info; ci < cinfo->num_components;
        ci++, compptr++) {
     int ssize = 1;
-    while (cinfo->min_DCT_h_scaled_size * ssize <=
+    while (cinfo->min_DCT_h_scaled_size * ssize < DCTSIZE &&
+	   cinfo->min_DCT_h_scaled_size * ssize <=
 	   (cinfo->do_fancy_upsampling ? DCTSIZE : DCTSIZE / 2) &&
 	   (cinfo->max_h_samp_factor % (compptr->h_samp_factor * ssize * 2)) == 0) {
       ssize = ssize * 2;
     }
     compptr->DCT_h_scaled_size = cinfo->min_DCT_h_scaled_size * ssize;
     ssize = 1;
-    while (cinfo->min_DCT_v_scaled_size * ssize <=
+    while (cinfo->min_DCT_v_scaled_size * ssize < DCTSIZE &&
+	   cinfo->min_DCT_v_scaled_size * ssize <=
 	   (cinfo->do_fancy_upsampling ? DCTSIZE : DCTSIZE / 2) &&
 	   (cinfo->max_v_samp_factor % (compptr->v_samp_factor * ssize * 2)) == 0) {
       ssize = ssize * 2;
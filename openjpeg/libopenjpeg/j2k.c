@@ -1747,6 +1747,10 @@ void j2k_setup_decoder(opj_j2k_t *j2k, opj_dparameters_t *parameters) {
 		cp->reduce = parameters->cp_reduce;
 		cp->layer = parameters->cp_layer;
 		cp->limit_decoding = parameters->cp_limit_decoding;
+		cp->threads = parameters->cp_threads;
+		cp->run_jobs = parameters->run_jobs;
+		cp->run_jobs_client = parameters->run_jobs_client;
+		memcpy(cp->region, parameters->cp_region, sizeof(cp->region));
 
 #ifdef USE_JPWL
 		cp->correct = parameters->jpwl_correct;
@@ -228,6 +228,13 @@ typedef struct opj_cp {
 	int layer;
 	/** if == NO_LIMITATION, decode entire codestream; if == LIMIT_TO_MAIN_HEADER then only decode the main header */
 	OPJ_LIMIT_DECODING limit_decoding;
+	/** number of jobs to decode the code-blocks of a tile in, see opj_dparameters_t */
+	int threads;
+	/** runs the jobs, possibly in parallel */
+	opj_run_jobs_fn run_jobs;
+	void *run_jobs_client;
+	/** region of interest (x0, y0, x1, y1) as fractions of the image; empty = all */
+	float region[4];
 	/** XTOsiz */
 	int tx0;
 	/** YTOsiz */
@@ -380,6 +380,12 @@ typedef struct opj_cparameters {
 	char tcp_mct;
 } opj_cparameters_t;
 
+/**
+Run count jobs of job_size bytes each, from the array jobs, by calling fn on each of them,
+possibly in parallel, and return when all of them are done.
+*/
+typedef void (*opj_run_jobs_fn)(void *client, void (*fn)(void *job), void *jobs, int job_size, int count);
+
 /**
 Decompression parameters
 */
@@ -432,6 +438,22 @@ typedef struct opj_dparameters {
 	*/
 	OPJ_LIMIT_DECODING cp_limit_decoding;
 
+	/**
+	Set the number of jobs that the code-blocks of a tile are decoded in.
+	The jobs are handed to run_jobs, with run_jobs_client, which may run them in parallel.
+	if <= 1 or run_jobs is NULL, the code-blocks are decoded one after the other
+	*/
+	int cp_threads;
+	opj_run_jobs_fn run_jobs;
+	void *run_jobs_client;
+	/**
+	Set the region of interest (x0, y0, x1, y1), as fractions of the image width and height
+	from its top left corner. Only the tiles that overlap the region are decoded; the others
+	are left blank.
+	if x1 <= x0 or y1 <= y0, all the tiles are decoded
+	*/
+	float cp_region[4];
+
 } opj_dparameters_t;
 
 /** Common fields between JPEG-2000 compression and decompression master structs. */
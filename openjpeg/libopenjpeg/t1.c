@@ -1488,94 +1488,203 @@ void t1_encode_cblks(
 	} /* compno  */
 }
 
-void t1_decode_cblks(
-		opj_t1_t* t1,
-		opj_tcd_tilecomp_t* tilec,
-		opj_tccp_t* tccp)
-{
-	int resno, bandno, precno, cblkno;
+/**
+A code-block to decode, with what is needed to place it in the tile component
+*/
+typedef struct opj_t1_cblk_ref {
+	opj_tcd_tilecomp_t *tilec;
+	opj_tccp_t *tccp;
+	opj_tcd_resolution_t *res;
+	opj_tcd_band_t *band;
+	opj_tcd_cblk_dec_t *cblk;
+} opj_t1_cblk_ref_t;
 
+/**
+A share of the code-blocks of a tile: refs[first], refs[first + step], ... below refs[count]
+*/
+typedef struct opj_t1_job {
+	opj_t1_t *t1;
+	opj_t1_cblk_ref_t *refs;
+	int first, step, count;
+} opj_t1_job_t;
+
+static void t1_decode_cblk_into_tile(opj_t1_t *t1, opj_t1_cblk_ref_t *ref) {
+	opj_tcd_tilecomp_t* tilec = ref->tilec;
+	opj_tccp_t* tccp = ref->tccp;
+	opj_tcd_band_t* restrict band = ref->band;
+	opj_tcd_cblk_dec_t* cblk = ref->cblk;
 	int tile_w = tilec->x1 - tilec->x0;
+	int* restrict datap;
+	int cblk_w, cblk_h;
+	int x, y;
+	int i, j;
+
+	t1_decode_cblk(
+			t1,
+			cblk,
+			band->bandno,
+			tccp->roishift,
+			tccp->cblksty);
+
+	x = cblk->x0 - band->x0;
+	y = cblk->y0 - band->y0;
+	if (band->bandno & 1) {
+		opj_tcd_resolution_t* pres = ref->res - 1;
+		x += pres->x1 - pres->x0;
+	}
+	if (band->bandno & 2) {
+		opj_tcd_resolution_t* pres = ref->res - 1;
+		y += pres->y1 - pres->y0;
+	}
 
-	for (resno = 0; resno < tilec->numresolutions; ++resno) {
-		opj_tcd_resolution_t* res = &tilec->resolutions[resno];
-
-		for (bandno = 0; bandno < res->numbands; ++bandno) {
-			opj_tcd_band_t* restrict band = &res->bands[bandno];
-
-			for (precno = 0; precno < res->pw * res->ph; ++precno) {
-				opj_tcd_precinct_t* precinct = &band->precincts[precno];
-
-				for (cblkno = 0; cblkno < precinct->cw * precinct->ch; ++cblkno) {
-					opj_tcd_cblk_dec_t* cblk = &precinct->cblks.dec[cblkno];
-					int* restrict datap;
-					int cblk_w, cblk_h;
-					int x, y;
-					int i, j;
-
-					t1_decode_cblk(
-							t1,
-							cblk,
-							band->bandno,
-							tccp->roishift,
-							tccp->cblksty);
-
-					x = cblk->x0 - band->x0;
-					y = cblk->y0 - band->y0;
-					if (band->bandno & 1) {
-						opj_tcd_resolution_t* pres = &tilec->resolutions[resno - 1];
-						x += pres->x1 - pres->x0;
-					}
-					if (band->bandno & 2) {
-						opj_tcd_resolution_t* pres = &tilec->resolutions[resno - 1];
-						y += pres->y1 - pres->y0;
-					}
+	datap=t1->data;
+	cblk_w = t1->w;
+	cblk_h = t1->h;
+
+	if (tccp->roishift) {
+		int thresh = 1 << tccp->roishift;
+		for (j = 0; j < cblk_h; ++j) {
+			for (i = 0; i < cblk_w; ++i) {
+				int val = datap[(j * cblk_w) + i];
+				int mag = abs(val);
+				if (mag >= thresh) {
+					mag >>= tccp->roishift;
+					datap[(j * cblk_w) + i] = val < 0 ? -mag : mag;
+				}
+			}
+		}
+	}
 
-					datap=t1->data;
-					cblk_w = t1->w;
-					cblk_h = t1->h;
-
-					if (tccp->roishift) {
-						int thresh = 1 << tccp->roishift;
-						for (j = 0; j < cblk_h; ++j) {
-							for (i = 0; i < cblk_w; ++i) {
-								int val = datap[(j * cblk_w) + i];
-								int mag = abs(val);
-								if (mag >= thresh) {
-									mag >>= tccp->roishift;
-									datap[(j * cblk_w) + i] = val < 0 ? -mag : mag;
-								}
-							}
+	if (tccp->qmfbid == 1) {
+		int* restrict tiledp = &tilec->data[(y * tile_w) + x];
+		for (j = 0; j < cblk_h; ++j) {
+			for (i = 0; i < cblk_w; ++i) {
+				int tmp = datap[(j * cblk_w) + i];
+				((int*)tiledp)[(j * tile_w) + i] = tmp / 2;
+			}
+		}
+	} else {		/* if (tccp->qmfbid == 0) */
+		float* restrict tiledp = (float*) &tilec->data[(y * tile_w) + x];
+		for (j = 0; j < cblk_h; ++j) {
+			float* restrict tiledp2 = tiledp;
+			for (i = 0; i < cblk_w; ++i) {
+				float tmp = *datap * band->stepsize;
+				*tiledp2 = tmp;
+				datap++;
+				tiledp2++;
+			}
+			tiledp += tile_w;
+		}
+	}
+}
+
+static void t1_decode_job(void *arg) {
+	opj_t1_job_t *job = (opj_t1_job_t*) arg;
+	int i;
+
+	for (i = job->first; i < job->count; i += job->step) {
+		t1_decode_cblk_into_tile(job->t1, &job->refs[i]);
+	}
+}
+
+bool t1_decode_cblks(
+		opj_common_ptr cinfo,
+		opj_tcd_tile_t* tile,
+		opj_tcp_t* tcp,
+		opj_cp_t* cp,
+		const int* numres)
+{
+	int compno, resno, bandno, precno, cblkno;
+	opj_t1_cblk_ref_t *refs = NULL;
+	opj_t1_job_t *jobs = NULL;
+	int nrefs = 0, njobs = 0, i;
+	bool ok = true;
+
+	/* Collect the code-blocks of the resolutions to decode. */
+	for (compno = 0; compno < tile->numcomps; ++compno) {
+		opj_tcd_tilecomp_t* tilec = &tile->comps[compno];
+		for (resno = 0; resno < numres[compno]; ++resno) {
+			opj_tcd_resolution_t* res = &tilec->resolutions[resno];
+			for (bandno = 0; bandno < res->numbands; ++bandno) {
+				opj_tcd_band_t* band = &res->bands[bandno];
+				for (precno = 0; precno < res->pw * res->ph; ++precno) {
+					nrefs += band->precincts[precno].cw * band->precincts[precno].ch;
+				}
+			}
+		}
+	}
+	if (nrefs > 0) {
+		refs = (opj_t1_cblk_ref_t*) opj_malloc(nrefs * sizeof(opj_t1_cblk_ref_t));
+		njobs = (cp->run_jobs != NULL && cp->threads > 1) ? int_min(cp->threads, nrefs) : 1;
+		jobs = (opj_t1_job_t*) opj_calloc(njobs, sizeof(opj_t1_job_t));
+		ok = refs != NULL && jobs != NULL;
+	}
+	if (ok && nrefs > 0) {
+		i = 0;
+		for (compno = 0; compno < tile->numcomps; ++compno) {
+			opj_tcd_tilecomp_t* tilec = &tile->comps[compno];
+			for (resno = 0; resno < numres[compno]; ++resno) {
+				opj_tcd_resolution_t* res = &tilec->resolutions[resno];
+				for (bandno = 0; bandno < res->numbands; ++bandno) {
+					opj_tcd_band_t* band = &res->bands[bandno];
+					for (precno = 0; precno < res->pw * res->ph; ++precno) {
+						opj_tcd_precinct_t* precinct = &band->precincts[precno];
+						for (cblkno = 0; cblkno < precinct->cw * precinct->ch; ++cblkno) {
+							refs[i].tilec = tilec;
+							refs[i].tccp = &tcp->tccps[compno];
+							refs[i].res = res;
+							refs[i].band = band;
+							refs[i].cblk = &precinct->cblks.dec[cblkno];
+							i++;
 						}
 					}
+				}
+			}
+		}
+		/* Deal the code-blocks out to the jobs in turn, so that each gets */
+		/* a share of every resolution. */
+		for (i = 0; i < njobs; i++) {
+			jobs[i].t1 = t1_create(cinfo);
+			jobs[i].refs = refs;
+			jobs[i].first = i;
+			jobs[i].step = njobs;
+			jobs[i].count = nrefs;
+			if (jobs[i].t1 == NULL)
+				ok = false;
+		}
+		if (ok) {
+			if (njobs > 1) {
+				cp->run_jobs(cp->run_jobs_client, t1_decode_job, jobs, sizeof(opj_t1_job_t), njobs);
+			} else {
+				t1_decode_job(&jobs[0]);
+			}
+		}
+		for (i = 0; i < njobs; i++) {
+			t1_destroy(jobs[i].t1);
+		}
+	}
+	opj_free(jobs);
+	opj_free(refs);
 
-					if (tccp->qmfbid == 1) {
-						int* restrict tiledp = &tilec->data[(y * tile_w) + x];
-						for (j = 0; j < cblk_h; ++j) {
-							for (i = 0; i < cblk_w; ++i) {
-								int tmp = datap[(j * cblk_w) + i];
-								((int*)tiledp)[(j * tile_w) + i] = tmp / 2;
-							}
-						}
-					} else {		/* if (tccp->qmfbid == 0) */
-						float* restrict tiledp = (float*) &tilec->data[(y * tile_w) + x];
-						for (j = 0; j < cblk_h; ++j) {
-							float* restrict tiledp2 = tiledp;
-							for (i = 0; i < cblk_w; ++i) {
-								float tmp = *datap * band->stepsize;
-								*tiledp2 = tmp;
-								datap++;
-								tiledp2++;
-							}
-							tiledp += tile_w;
-						}
+	/* Free the code-blocks, including those of the discarded resolutions. */
+	for (compno = 0; compno < tile->numcomps; ++compno) {
+		opj_tcd_tilecomp_t* tilec = &tile->comps[compno];
+		for (resno = 0; resno < tilec->numresolutions; ++resno) {
+			opj_tcd_resolution_t* res = &tilec->resolutions[resno];
+			for (bandno = 0; bandno < res->numbands; ++bandno) {
+				opj_tcd_band_t* band = &res->bands[bandno];
+				for (precno = 0; precno < res->pw * res->ph; ++precno) {
+					opj_tcd_precinct_t* precinct = &band->precincts[precno];
+					for (cblkno = 0; cblkno < precinct->cw * precinct->ch; ++cblkno) {
+						opj_tcd_cblk_dec_t* cblk = &precinct->cblks.dec[cblkno];
+						opj_free(cblk->data);
+						opj_free(cblk->segs);
 					}
-					opj_free(cblk->data);
-					opj_free(cblk->segs);
-				} /* cblkno */
-				opj_free(precinct->cblks.dec);
-			} /* precno */
-		} /* bandno */
-	} /* resno */
+					opj_free(precinct->cblks.dec);
+				}
+			}
+		}
+	}
+	return ok;
 }
 
@@ -133,12 +133,15 @@ Encode the code-blocks of a tile
 */
 void t1_encode_cblks(opj_t1_t *t1, opj_tcd_tile_t *tile, opj_tcp_t *tcp);
 /**
-Decode the code-blocks of a tile
-@param t1 T1 handle
-@param tilec The tile to decode
-@param tccp Tile coding parameters
+Decode the code-blocks of a tile, and free them
+@param cinfo Codec context info
+@param tile The tile to decode
+@param tcp Tile coding parameters
+@param cp Coding parameters, with the number of jobs to decode in and how to run them
+@param numres Number of resolutions to decode, for each component
+@return Returns false if the memory for the jobs could not be allocated
 */
-void t1_decode_cblks(opj_t1_t* t1, opj_tcd_tilecomp_t* tilec, opj_tccp_t* tccp);
+bool t1_decode_cblks(opj_common_ptr cinfo, opj_tcd_tile_t* tile, opj_tcp_t* tcp, opj_cp_t* cp, const int* numres);
 /* ----------------------------------------------------------------------- */
 /*@}*/
 
@@ -1319,14 +1319,27 @@ int tcd_encode_tile(opj_tcd_t *tcd, int tileno, unsigned char *dest, int len, op
 	return l;
 }
 
+/* Does the tile overlap the region of interest, if any? */
+static bool tcd_tile_in_region(opj_tcd_t *tcd, opj_tcd_tile_t *tile) {
+	const float *r = tcd->cp->region;
+	opj_image_t *image = tcd->image;
+	float w = (float)(image->x1 - image->x0), h = (float)(image->y1 - image->y0);
+
+	if (r[2] <= r[0] || r[3] <= r[1])
+		return true;
+	return (tile->x1 - image->x0) / w > r[0] && (tile->x0 - image->x0) / w < r[2] &&
+		(tile->y1 - image->y0) / h > r[1] && (tile->y0 - image->y0) / h < r[3];
+}
+
 bool tcd_decode_tile(opj_tcd_t *tcd, unsigned char *src, int len, int tileno, opj_codestream_info_t *cstr_info) {
 	int l;
 	int compno;
 	int eof = 0;
 	double tile_time, t1_time, dwt_time;
 	opj_tcd_tile_t *tile = NULL;
+	int *numres;			/* resolutions to decode per component */
+	bool skip;			/* outside the region of interest */
 
-	opj_t1_t *t1 = NULL;		/* T1 component */
 	opj_t2_t *t2 = NULL;		/* T2 component */
 	
 	tcd->tcd_tileno = tileno;
@@ -1378,14 +1391,31 @@ bool tcd_decode_tile(opj_tcd_t *tcd, unsigned char *src, int len, int tileno, op
 	/*------------------TIER1-----------------*/
 	
 	t1_time = opj_clock();	/* time needed to decode a tile */
-	t1 = t1_create(tcd->cinfo);
+	skip = !tcd_tile_in_region(tcd, tile);
+	numres = (int*) opj_malloc(tile->numcomps * sizeof(int));
+	if (numres == NULL) {
+		opj_event_msg(tcd->cinfo, EVT_ERROR, "tcd_decode: out of memory\n");
+		return false;
+	}
 	for (compno = 0; compno < tile->numcomps; ++compno) {
 		opj_tcd_tilecomp_t* tilec = &tile->comps[compno];
+		int n = (tilec->x1 - tilec->x0) * (tilec->y1 - tilec->y0);
 		/* The +3 is headroom required by the vectorized DWT */
-		tilec->data = (int*) opj_aligned_malloc((((tilec->x1 - tilec->x0) * (tilec->y1 - tilec->y0))+3) * sizeof(int));
-		t1_decode_cblks(t1, tilec, &tcd->tcp->tccps[compno]);
+		tilec->data = (int*) opj_aligned_malloc((n + 3) * sizeof(int));
+		/* Leave the tiles outside the region blank, and don't decode */
+		/* the code-blocks of the resolutions that will be discarded. */
+		if (skip) {
+			memset(tilec->data, 0, n * sizeof(int));
+			numres[compno] = 0;
+		} else {
+			numres[compno] = int_max(tilec->numresolutions - tcd->cp->reduce, 0);
+		}
+	}
+	if (!t1_decode_cblks(tcd->cinfo, tile, tcd->tcp, tcd->cp, numres)) {
+		eof = 1;
+		opj_event_msg(tcd->cinfo, EVT_ERROR, "tcd_decode: out of memory\n");
 	}
-	t1_destroy(t1);
+	opj_free(numres);
 	t1_time = opj_clock() - t1_time;
 	opj_event_msg(tcd->cinfo, EVT_INFO, "- tiers-1 took %f s\n", t1_time);
 	
@@ -1407,7 +1437,7 @@ bool tcd_decode_tile(opj_tcd_t *tcd, unsigned char *src, int len, int tileno, op
 		}
 
 		numres2decode = tcd->image->comps[compno].resno_decoded + 1;
-		if(numres2decode > 0){
+		if(numres2decode > 0 && !skip){
 			if (tcd->tcp->tccps[compno].qmfbid == 1) {
 				dwt_decode(tilec, numres2decode);
 			} else {
@@ -35,6 +35,7 @@
 #define dtop_npairs (idict_stack.top_npairs)
 #define dtop_values (idict_stack.top_values)
 #define dict_set_top() dstack_set_top(&idict_stack);
+#define dict_set_top_begin() dstack_set_top_begin(&idict_stack);
 #define dict_is_permanent_on_dstack(pdict)\
   dstack_dict_is_permanent(&idict_stack, pdict)
 #define dicts_gc_cleanup() dstack_gc_cleanup(&idict_stack)
@@ -62,6 +62,7 @@ ialloc_init(gs_dual_memory_t *dmem, gs_memory_t * rmem, uint chunk_size,
     dmem->space_system = ismem;
     dmem->spaces.vm_reclaim = gs_gc_reclaim; /* real GC */
     dmem->reclaim = 0;		/* no interpreter GC yet */
+    memset(&dmem->gc_stats, 0, sizeof(dmem->gc_stats));
     /* Level 1 systems have only local VM. */
     igmem->space = avm_global;
     igmem_stable->space = avm_global;
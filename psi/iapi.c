@@ -254,6 +254,28 @@ gsapi_run_file(void *lib, const char *file_name,
                             &(get_minst_from_memory(ctx->memory)->error_object));
 }
 
+/* Checkpoint the interpreter state, for resetting between jobs */
+GSDLLEXPORT int GSDLLAPI
+gsapi_save_checkpoint(void *lib)
+{
+    gs_lib_ctx_t *ctx = (gs_lib_ctx_t *)lib;
+    if (lib == NULL)
+        return e_Fatal;
+
+    return gs_main_save_checkpoint(get_minst_from_memory(ctx->memory));
+}
+
+/* Discard everything done since the checkpoint */
+GSDLLEXPORT int GSDLLAPI
+gsapi_restore_checkpoint(void *lib)
+{
+    gs_lib_ctx_t *ctx = (gs_lib_ctx_t *)lib;
+    if (lib == NULL)
+        return e_Fatal;
+
+    return gs_main_restore_checkpoint(get_minst_from_memory(ctx->memory));
+}
+
 /* Exit the interpreter */
 GSDLLEXPORT int GSDLLAPI
 gsapi_exit(void *lib)
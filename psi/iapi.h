@@ -237,6 +237,27 @@ GSDLLEXPORT int GSDLLAPI
 gsapi_run_file(void *instance,
     const char *file_name, int user_errors, int *pexit_code);
 
+/* Checkpoint an initialized interpreter so that it can be reset between
+ * jobs without repeating the initialization.
+ * gsapi_save_checkpoint() must be called after gsapi_init_with_args(),
+ * outside any save, and records the state of local and global VM and
+ * of the graphics state, including the current device.  The instance
+ * must be initialized with -dNOOUTERSAVE: otherwise the initialization
+ * leaves a save in effect, and e_invalidaccess is returned.
+ * gsapi_restore_checkpoint() clears the operand and dictionary stacks
+ * and restores to the checkpoint, discarding all definitions, VM
+ * allocations, files and device changes made since; the checkpoint
+ * remains in effect for the next job.  If the restore fails, its error
+ * is returned and the checkpoint is kept.  If taking the new checkpoint
+ * after it fails, that error is returned and gsapi_save_checkpoint()
+ * must be called again.
+ */
+GSDLLEXPORT int GSDLLAPI
+gsapi_save_checkpoint(void *instance);
+
+GSDLLEXPORT int GSDLLAPI
+gsapi_restore_checkpoint(void *instance);
+
 /* Exit the interpreter.
  * This must be called on shutdown if gsapi_init_with_args()
  * has been called, and just before gsapi_delete_instance().
@@ -282,6 +303,8 @@ typedef int (GSDLLAPIPTR PFN_gsapi_run_string)(
     int user_errors, int *pexit_code);
 typedef int (GSDLLAPIPTR PFN_gsapi_run_file)(void *instance,
     const char *file_name, int user_errors, int *pexit_code);
+typedef int (GSDLLAPIPTR PFN_gsapi_save_checkpoint)(void *instance);
+typedef int (GSDLLAPIPTR PFN_gsapi_restore_checkpoint)(void *instance);
 typedef int (GSDLLAPIPTR PFN_gsapi_exit)(void *instance);
 typedef void (GSDLLAPIPTR PFN_gsapi_set_visual_tracer)
     (struct vd_trace_interface_s *I);
@@ -31,6 +31,12 @@ typedef struct dict_stack_s dict_stack_t;
  */
 void dstack_set_top(dict_stack_t *);
 
+/*
+ * Do the same after begin has pushed a dictionary, and nothing else has
+ * changed.
+ */
+void dstack_set_top_begin(dict_stack_t *);
+
 /* Check whether a dictionary is one of the permanent ones on the d-stack. */
 bool dstack_dict_is_permanent(const dict_stack_t *, const ref *);
 
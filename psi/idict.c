@@ -514,6 +514,9 @@ dict_put(ref * pdref /* t_dictionary */ , const ref * pkey, const ref * pvalue,
         if (r_has_type(pkey, t_name)) {
             name *pname = pkey->value.pname;
 
+            /* The new definition may hide a cached one. */
+            names_lookup_cache_forget(pmem->gs_lib_ctx->gs_name_table,
+                                      name_index(pmem, pkey));
             if (pname->pvalue == pv_no_defn &&
                 CAN_SET_PVALUE_CACHE(pds, pdref, mem)
                 ) {		/* Set the cache. */
@@ -631,6 +634,8 @@ dict_undef(ref * pdref, const ref * pkey, dict_stack_t *pds)
     }
     ref_save_in(mem, pdref, &pdict->count, "dict_undef(count)");
     pdict->count.value.intval--;
+    /* The key may be a string, so drop all the dstack lookups. */
+    names_lookup_cache_clear(dict_mem(pdict)->gs_lib_ctx->gs_name_table);
     /* If the key is a name, update its 1-element cache. */
     if (r_has_type(pkey, t_name)) {
         name *pname = pkey->value.pname;
@@ -797,6 +802,8 @@ dict_resize(ref * pdref, uint new_size, dict_stack_t *pds)
     ref_save_in(dict_memory(pdict), pdref, &pdict->maxlength,
                 "dict_resize(maxlength)");
     d_set_maxlength(pdict, new_size);
+    /* The values have moved. */
+    names_lookup_cache_clear(dict_mem(pdict)->gs_lib_ctx->gs_name_table);
     if (pds)
         dstack_set_top(pds);	/* just in case this is the top dict */
     return 0;
@@ -97,11 +97,11 @@ dstack_dict_is_permanent(const dict_stack_t * pds, const ref * pdref)
 }
 
 /*
- * Look up a name on the dictionary stack.
+ * Search for a name on the dictionary stack.
  * Return the pointer to the value if found, 0 if not.
  */
-ref *
-dstack_find_name_by_index(dict_stack_t * pds, uint nidx)
+static ref *
+dstack_search_name_by_index(dict_stack_t * pds, uint nidx)
 {
     ds_ptr pdref = pds->stack.p;
 
@@ -198,12 +198,38 @@ dstack_find_name_by_index(dict_stack_t * pds, uint nidx)
 #undef hash
 }
 
+/* Get the name table, which holds the lookup cache (see inamedef.h). */
+#define dstack_name_table(pds)\
+  (((gs_memory_t *)(pds)->stack.memory)->gs_lib_ctx->gs_name_table)
+
+/*
+ * Look up a name on the dictionary stack, using the lookup cache.
+ * Return the pointer to the value if found, 0 if not.
+ */
+ref *
+dstack_find_name_by_index(dict_stack_t * pds, uint nidx)
+{
+    name_table *nt = dstack_name_table(pds);
+    name_lookup_cache_t *pce = names_lookup_cache_entry(nt, nidx);
+    ref *pvalue;
+
+    if (pce->nidx == nidx && pce->epoch == nt->lookup_epoch)
+        return pce->pvalue;
+    pvalue = dstack_search_name_by_index(pds, nidx);
+    if (pvalue != 0) {
+        pce->pvalue = pvalue;
+        pce->nidx = nidx;
+        pce->epoch = nt->lookup_epoch;
+    }
+    return pvalue;
+}
+
 /* Set the cached values computed from the top entry on the dstack. */
 /* See idstack.h for details. */
 static const ref_packed no_packed_keys[2] =
 {packed_key_deleted, packed_key_empty};
-void
-dstack_set_top(dict_stack_t * pds)
+static void
+dstack_load_top(dict_stack_t * pds)
 {
     ds_ptr dsp = pds->stack.p;
     dict *pdict = dsp->value.pdict;
@@ -225,6 +251,22 @@ dstack_set_top(dict_stack_t * pds)
     else
         pds->def_space = r_space(dsp);
 }
+void
+dstack_set_top(dict_stack_t * pds)
+{
+    names_lookup_cache_clear(dstack_name_table(pds));
+    dstack_load_top(pds);
+}
+
+/* Do the same after begin, which can't hide anything if it pushed an */
+/* empty dictionary (typically the local dictionary of a procedure). */
+void
+dstack_set_top_begin(dict_stack_t * pds)
+{
+    if (d_length(pds->stack.p->value.pdict) != 0)
+        names_lookup_cache_clear(dstack_name_table(pds));
+    dstack_load_top(pds);
+}
 
 /* After a garbage collection, scan the permanent dictionaries and */
 /* update the cached value pointers in names. */
@@ -234,6 +276,7 @@ dstack_gc_cleanup(dict_stack_t * pds)
     uint count = ref_stack_count(&pds->stack);
     uint dsi;
 
+    names_lookup_cache_clear(dstack_name_table(pds));
     for (dsi = pds->min_size; dsi > 0; --dsi) {
         const dict *pdict =
         ref_stack_index(&pds->stack, count - dsi)->value.pdict;
@@ -32,7 +32,8 @@ void dstack_gc_cleanup(dict_stack_t *);
 
 /*
  * Define a special fast entry for name lookup on a dictionary stack.
- * The key is known to be a name; search the entire dict stack.
+ * The key is known to be a name; search the entire dict stack, unless
+ * the name table's lookup cache already has the answer.
  * Return the pointer to the value slot.
  * If the name isn't found, just return 0.
  */
@@ -43,6 +43,14 @@ int filter_read(
         /* the state, 0 if no such parameters */
                 uint space
                 );
+/*
+ * As filter_read, but give the filter a buffer of at least bsize bytes
+ * instead of the default size (file_default_buffer_size).  This is for
+ * filters like FlateDecode that are much faster with bigger buffers.
+ */
+int filter_read_sized(i_ctx_t *i_ctx_p, int npop,
+                      const stream_template * templat,
+                      stream_state * st, uint space, uint bsize);
 int filter_write(i_ctx_t *i_ctx_p, int npop,
                  const stream_template * templat,
                  stream_state * st, uint space);
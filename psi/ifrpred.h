@@ -20,8 +20,10 @@
 #  define ifrpred_INCLUDED
 
 /* Exported by zfdecode.c for zfzlib.c */
+/* bsize is the minimum buffer size for the decompression filter, */
+/* 0 for the default (see filter_read_sized). */
 int filter_read_predictor(i_ctx_t *i_ctx_p, int npop,
                           const stream_template * templat,
-                          stream_state * st);
+                          stream_state * st, uint bsize);
 
 #endif /* ifrpred_INCLUDED */
@@ -750,6 +750,72 @@ gs_pop_string(gs_main_instance * minst, gs_string * result)
     return code;
 }
 
+/* ------ Job checkpoints ------ */
+
+/* Run a fixed string, and pop the save object it leaves. */
+static int
+run_checkpoint_string(gs_main_instance * minst, const char *str)
+{
+    i_ctx_t *i_ctx_p;
+    int exit_code;
+    ref error_object;
+    ref vref;
+    int code = gs_main_run_string(minst, str, 0, &exit_code, &error_object);
+
+    if (code < 0)
+        return code;
+    i_ctx_p = minst->i_ctx_p;
+    code = pop_value(i_ctx_p, &vref);
+    if (code < 0)
+        return code;
+    check_type_only(vref, t_save);
+    minst->checkpoint = vref;
+    ref_stack_pop(&o_stack, 1);
+    return 0;
+}
+
+int
+gs_main_save_checkpoint(gs_main_instance * minst)
+{
+    i_ctx_t *i_ctx_p = minst->i_ctx_p;
+
+    if (minst->init_done < 2)
+        return_error(e_undefined);
+    /* Only an outermost save also covers global VM, so the save
+     * that the initialization does unless NOOUTERSAVE is set
+     * would leave global VM out of the checkpoint. */
+    if (imemory_save_level(iimemory_local) != 0) {
+        emprintf(minst->heap,
+                 "Checkpoints require the instance to be initialized with -dNOOUTERSAVE.\n");
+        return_error(e_invalidaccess);
+    }
+    return run_checkpoint_string(minst, "save");
+}
+
+int
+gs_main_restore_checkpoint(gs_main_instance * minst)
+{
+    i_ctx_t *i_ctx_p = minst->i_ctx_p;
+    int exit_code;
+    ref error_object;
+    int code;
+
+    if (!r_has_type(&minst->checkpoint, t_save))
+        return_error(e_invalidrestore);
+    /* Drop anything the job left on the stacks, including the remains
+     * of an error, since restore would reject them. */
+    gs_interp_reset(i_ctx_p);
+    code = push_value(minst, &minst->checkpoint);
+    if (code < 0)
+        return code;
+    code = gs_main_run_string(minst, "restore", 0, &exit_code, &error_object);
+    if (code < 0)
+        return code;		/* the checkpoint is still valid */
+    /* The restore consumed the save, so take a new one straight away. */
+    make_null(&minst->checkpoint);
+    return run_checkpoint_string(minst, "save");
+}
+
 /* ------ Termination ------ */
 
 /* Get the names of temporary files.
@@ -819,6 +885,10 @@ gs_main_finit(gs_main_instance * minst, int exit_status, int code)
      * alloc_restore_all will close dynamically allocated devices.
      */
     tempnames = gs_main_tempnames(minst);
+    /* Report the VM statistics before tearing anything down (-dVMSTATS). */
+    if (minst->init_done >= 2)
+        gs_main_run_string(minst, "systemdict /VMSTATS .knownget { { .printvmstats } if } if",
+                           0, &exit_code, &error_object);
     /*
      * Close the "main" device, because it may need to write out
      * data before destruction. pdfwrite needs so.
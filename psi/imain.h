@@ -225,6 +225,22 @@ int gs_pop_real(gs_main_instance * minst, float *result);
 /* gs_pop_string returns 1 if the string is read-only. */
 int gs_pop_string(gs_main_instance * minst, gs_string * result);
 
+/* ---------------- Job checkpoints ---------------- */
+
+/*
+ * gs_main_save_checkpoint does an outermost save of the initialized
+ * interpreter (which therefore must run with NOOUTERSAVE).  This covers
+ * both local and global VM and the graphics state (and hence the current
+ * device and its page device parameters).
+ * gs_main_save_checkpoint returns e_invalidaccess if a save is in effect.
+ * gs_main_restore_checkpoint resets the interpreter stacks,
+ * restores to the checkpoint, discarding everything done since, and
+ * immediately takes a new checkpoint at the same place.  A failed
+ * restore leaves the checkpoint in place.
+ */
+int gs_main_save_checkpoint(gs_main_instance * minst);
+int gs_main_restore_checkpoint(gs_main_instance * minst);
+
 /* ---------------- Debugging ---------------- */
 
 /*
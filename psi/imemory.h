@@ -81,6 +81,22 @@ int gs_register_ref_root(gs_memory_t *mem, gs_gc_root_t *root,
 #  define gs_dual_memory_DEFINED
 typedef struct gs_dual_memory_s gs_dual_memory_t;
 #endif
+/*
+ * Garbage collection statistics.  These live in the dual memory rather
+ * than in the allocators, so that save and restore don't reset them.
+ * Times are in microseconds, sizes in bytes.
+ */
+typedef struct gs_gc_stats_s {
+    ulong count;		/* # of collections */
+    ulong global_count;		/* # of those that included global VM */
+    ulong total_time;
+    ulong max_time;
+    ulong last_time;
+    ulong freed;		/* total decrease in VM in use */
+    ulong released;		/* total decrease in VM allocated */
+    ulong last_freed;
+    ulong last_released;
+} gs_gc_stats_t;
 struct gs_dual_memory_s {
     gs_ref_memory_t *current;	/* = ...global or ...local */
     vm_spaces spaces;		/* system, global, local */
@@ -90,6 +106,7 @@ struct gs_dual_memory_s {
     /* Masks for store checking, see isave.h. */
     uint test_mask;
     uint new_mask;
+    gs_gc_stats_t gc_stats;
 };
 
 #define public_st_gs_dual_memory()	/* in ialloc.c */\
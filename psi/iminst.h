@@ -70,6 +70,7 @@ struct gs_main_instance_s {
     long base_time[2];		/* starting usertime */
     void *readline_data;	/* data for gp_readline */
     ref error_object;		/* Use by gsapi_*() */
+    ref checkpoint;		/* outermost save for gsapi_*_checkpoint() */
 #if 1
     /* needs to be removed */
     display_callback *display;	/* callback structure for display device */
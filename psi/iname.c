@@ -50,6 +50,8 @@ gs_private_st_composite_final(st_name_table, name_table, "name_table",
                         name_table_enum_ptrs, name_table_reloc_ptrs,gs_names_finalize);
 
 /* Forward references */
+static int name_hash_alloc(name_table *, uint);
+static void name_hash_remove(name_table *, uint);
 static int name_alloc_sub(name_table *);
 static void name_free_sub(name_table *, uint, bool);
 static void name_scan_sub(name_table *, uint, bool, bool);
@@ -92,10 +94,15 @@ names_init(ulong count, gs_ref_memory_t *imem)
     if (nt == 0)
         return 0;
     memset(nt, 0, sizeof(name_table));
+    nt->memory = mem;
+    nt->lookup_epoch = 1;
+    if (name_hash_alloc(nt, NT_HASH_SIZE) < 0) {
+        gs_free_object(mem, nt, "name_init(nt)");
+        return 0;
+    }
     nt->max_sub_count =
         ((count - 1) | nt_sub_index_mask) >> nt_log2_sub_size;
     nt->name_string_attrs = imemory_space(imem) | a_readonly;
-    nt->memory = mem;
     /* Initialize the one-character names. */
     /* Start by creating the necessary sub-tables. */
     for (i = 0; i < NT_1CHAR_FIRST + NT_1CHAR_SIZE; i += nt_sub_size) {
@@ -104,6 +111,7 @@ names_init(ulong count, gs_ref_memory_t *imem)
         if (code < 0) {
             while (nt->sub_next > 0)
                 name_free_sub(nt, --(nt->sub_next), false);
+            gs_free_object(mem->non_gc_memory, nt->hash, "name_init(hash)");
             gs_free_object(mem, nt, "name_init(nt)");
             return 0;
         }
@@ -134,7 +142,10 @@ names_init(ulong count, gs_ref_memory_t *imem)
 static void
 gs_names_finalize(const gs_memory_t *cmem, void *vptr)
 {
-    (void)vptr; /* unused */
+    name_table *nt = (name_table *)vptr;
+
+    gs_free_object(nt->memory->non_gc_memory, nt->hash, "gs_names_finalize");
+    nt->hash = 0;
     cmem->gs_lib_ctx->gs_name_table = NULL;
 }
 
@@ -155,7 +166,7 @@ names_ref(name_table *nt, const byte *ptr, uint size, ref *pref, int enterflag)
     name *pname;
     name_string_t *pnstr;
     uint nidx;
-    uint *phash;
+    uint hash, hslot;
 
     /* Compute a hash for the string. */
     /* Make a special check for 1-character names. */
@@ -166,24 +177,21 @@ names_ref(name_table *nt, const byte *ptr, uint size, ref *pref, int enterflag)
         goto mkn;
     case 1:
         if (*ptr < NT_1CHAR_SIZE) {
-            uint hash = *ptr + NT_1CHAR_FIRST;
-
+            hash = *ptr + NT_1CHAR_FIRST;
             nidx = name_count_to_index(hash);
             pname = names_index_ptr_inline(nt, nidx);
             goto mkn;
         }
         /* falls through */
-    default: {
-        uint hash;
-
+    default:
         NAME_HASH(hash, hash_permutation, ptr, size);
-        phash = nt->hash + (hash & (NT_HASH_SIZE - 1));
-    }
     }
 
-    for (nidx = *phash; nidx != 0;
-         nidx = name_next_index(nidx, pnstr)
+    for (hslot = hash & nt->hash_mask; (nidx = nt->hash[hslot].nidx) != 0;
+         hslot = (hslot + 1) & nt->hash_mask
         ) {
+        if (nt->hash[hslot].hash != hash)
+            continue;
         pnstr = names_index_string_inline(nt, nidx);
         if (pnstr->string_size == size &&
             !memcmp_inline(ptr, pnstr->string_bytes, size)
@@ -197,6 +205,14 @@ names_ref(name_table *nt, const byte *ptr, uint size, ref *pref, int enterflag)
         return_error(e_undefined);
     if (size > max_name_string)
         return_error(e_limitcheck);
+    if ((nt->hash_count + 1) * 2 > nt->hash_mask + 1) {
+        int code = name_hash_alloc(nt, (nt->hash_mask + 1) * 2);
+
+        if (code < 0)
+            return code;
+        for (hslot = hash & nt->hash_mask; nt->hash[hslot].nidx != 0;)
+            hslot = (hslot + 1) & nt->hash_mask;
+    }
     nidx = nt->free;
     if (nidx == 0) {
         int code = name_alloc_sub(nt);
@@ -223,8 +239,10 @@ names_ref(name_table *nt, const byte *ptr, uint size, ref *pref, int enterflag)
     pname = name_index_ptr_inline(nt, nidx);
     pname->pvalue = pv_no_defn;
     nt->free = name_next_index(nidx, pnstr);
-    set_name_next_index(nidx, pnstr, *phash);
-    *phash = nidx;
+    set_name_next_index(nidx, pnstr, 0);
+    nt->hash[hslot].hash = hash;
+    nt->hash[hslot].nidx = nidx;
+    nt->hash_count++;
     if_debug_name("new name", nt, nidx, &enterflag);
  mkn:
     make_name(pref, nidx, pname);
@@ -274,6 +292,17 @@ names_invalidate_value_cache(name_table * nt, const ref * pnref)
     pnref->value.pname->pvalue = pv_other;
 }
 
+/* Invalidate the dictionary stack lookup cache. */
+void
+names_lookup_cache_clear(name_table * nt)
+{
+    if (++(nt->lookup_epoch) == 0) {
+        /* Don't let stale entries come back to life. */
+        memset(nt->lookup_cache, 0, sizeof(nt->lookup_cache));
+        nt->lookup_epoch = 1;
+    }
+}
+
 /* Convert between names and indices. */
 #undef names_index
 name_index_t
@@ -382,38 +411,26 @@ names_index_string_sub_table(name_table * nt, name_index_t index)
 void
 names_trace_finish(name_table * nt, gc_state_t * gcst)
 {
-    uint *phash = &nt->hash[0];
+    uint hslot = 0;
     int i;
 
-    for (i = 0; i < NT_HASH_SIZE; phash++, i++) {
-        name_index_t prev = 0;
-        /*
-         * The following initialization is only to pacify compilers:
-         * pnprev is only referenced if prev has been set in the loop,
-         * in which case pnprev is also set.
-         */
-        name_string_t *pnprev = 0;
-        name_index_t nidx = *phash;
-
-        while (nidx != 0) {
+    while (hslot <= nt->hash_mask) {
+        name_index_t nidx = nt->hash[hslot].nidx;
+
+        if (nidx != 0) {
             name_string_t *pnstr = names_index_string_inline(nt, nidx);
-            name_index_t next = name_next_index(nidx, pnstr);
 
-            if (pnstr->mark) {
-                prev = nidx;
-                pnprev = pnstr;
-            } else {
+            if (!pnstr->mark) {
                 if_debug_name("GC remove name", nt, nidx, NULL);
                 /* Zero out the string data for the GC. */
                 pnstr->string_bytes = 0;
                 pnstr->string_size = 0;
-                if (prev == 0)
-                    *phash = next;
-                else
-                    set_name_next_index(prev, pnprev, next);
+                /* A later entry may move into this slot: look again. */
+                name_hash_remove(nt, hslot);
+                continue;
             }
-            nidx = next;
         }
+        hslot++;
     }
     /* Reconstruct the free list. */
     nt->free = 0;
@@ -466,6 +483,66 @@ names_restore(name_table * nt, alloc_save_t * save)
 
 /* ------ Internal procedures ------ */
 
+/* (Re)allocate the hash index with a given number of slots. */
+static int
+name_hash_alloc(name_table * nt, uint size)
+{
+    gs_memory_t *mem = nt->memory->non_gc_memory;
+    name_hash_slot_t *old_hash = nt->hash;
+    uint old_size = (old_hash == 0 ? 0 : nt->hash_mask + 1);
+    name_hash_slot_t *hash;
+    uint i;
+
+    hash = (name_hash_slot_t *)
+        gs_alloc_byte_array(mem, size, sizeof(name_hash_slot_t),
+                            "name_hash_alloc");
+    if (hash == 0)
+        return_error(e_VMerror);
+    memset(hash, 0, size * sizeof(name_hash_slot_t));
+    for (i = 0; i < old_size; ++i)
+        if (old_hash[i].nidx != 0) {
+            uint hslot = old_hash[i].hash & (size - 1);
+
+            while (hash[hslot].nidx != 0)
+                hslot = (hslot + 1) & (size - 1);
+            hash[hslot] = old_hash[i];
+        }
+    gs_free_object(mem, old_hash, "name_hash_alloc");
+    nt->hash = hash;
+    nt->hash_mask = size - 1;
+    return 0;
+}
+
+/*
+ * Remove the entry in a slot of the hash index.  Since there are no
+ * deleted-slot markers, we have to move back any later entries of the same
+ * probe sequence that would no longer be reachable across the hole.
+ */
+static void
+name_hash_remove(name_table * nt, uint hslot)
+{
+    name_hash_slot_t *hash = nt->hash;
+    uint mask = nt->hash_mask;
+    uint next = hslot;
+
+    for (;;) {
+        uint home;
+
+        next = (next + 1) & mask;
+        if (hash[next].nidx == 0)
+            break;
+        home = hash[next].hash & mask;
+        /* Leave the entry alone if its home lies cyclically in (hslot, next]. */
+        if (hslot <= next ? hslot < home && home <= next :
+            hslot < home || home <= next)
+            continue;
+        hash[hslot] = hash[next];
+        hslot = next;
+    }
+    hash[hslot].nidx = 0;
+    nt->hash_count--;
+}
+
 /* Allocate the next sub-table. */
 static int
 name_alloc_sub(name_table * nt)
@@ -506,29 +583,8 @@ name_alloc_sub(name_table * nt)
     /* Note that the free list will only be properly sorted if */
     /* it was empty initially. */
     name_scan_sub(nt, sub_index, false, false);
-#ifdef DEBUG
-    if (gs_debug_c('n')) {	/* Print the lengths of the hash chains. */
-        int i0;
-
-        for (i0 = 0; i0 < NT_HASH_SIZE; i0 += 16) {
-            int i;
-
-            dlprintf1("[n]chain %d:", i0);
-            for (i = i0; i < i0 + 16; i++) {
-                int n = 0;
-                uint nidx;
-
-                for (nidx = nt->hash[i]; nidx != 0;
-                     nidx = name_next_index(nidx,
-                                            names_index_string_inline(nt, nidx))
-                    )
-                    n++;
-                dprintf1(" %d", n);
-            }
-            dputc('\n');
-        }
-    }
-#endif
+    if_debug2('n', "[n]hash index: %u of %u slots used\n",
+              nt->hash_count, nt->hash_mask + 1);
     return 0;
 }
 
@@ -88,6 +88,25 @@ typedef struct name_sub_table_s {
 #endif
 } name_sub_table;
 
+/*
+ * Define the cache for names looked up on the dictionary stack that can't
+ * use the pvalue cache (because they have more than one definition, or
+ * are defined in a non-permanent dictionary) and aren't found by the
+ * single probe of the top dictionary.  An entry records the value slot
+ * found for a name, and is valid while its epoch matches the table's.
+ * The epoch advances whenever the dictionary stack changes or the values
+ * of a dictionary may move (resize, restore, garbage collection); since
+ * adding a key can't move other entries, defining a name only drops the
+ * entry for that name, and pushing an empty dictionary (as a procedure
+ * does with its local dictionary) drops nothing.
+ */
+#define NT_LOOKUP_CACHE_SIZE 1024	/* must be a power of 2 */
+typedef struct name_lookup_cache_s {
+    ref *pvalue;
+    uint nidx;
+    uint epoch;
+} name_lookup_cache_t;
+
 /*
  * Now define the name table itself.
  * This must be made visible so that the interpreter can use the
@@ -103,7 +122,13 @@ struct name_table_s {
     uint max_sub_count;		/* max allowable value of sub_count */
     uint name_string_attrs;	/* imemory_space(memory) | a_readonly */
     gs_memory_t *memory;
-    uint hash[NT_HASH_SIZE];
+    /* The hash index is allocated in non-GC memory, and is doubled */
+    /* in size whenever it becomes more than half full. */
+    name_hash_slot_t *hash;
+    uint hash_mask;		/* # of slots - 1 */
+    uint hash_count;		/* # of occupied slots */
+    uint lookup_epoch;
+    name_lookup_cache_t lookup_cache[NT_LOOKUP_CACHE_SIZE];
     struct sub_ {		/* both ptrs are 0 or both are non-0 */
         name_sub_table *names;
         name_string_sub_table_t *strings;
@@ -151,6 +176,24 @@ struct name_table_s {
 #define make_name(pnref, nidx, pnm)\
   make_tasv(pnref, t_name, avm_system, (ushort)(nidx), pname, pnm)
 
+/* ------ Dictionary stack lookup cache ------ */
+
+#define names_lookup_cache_entry(nt, index)\
+  (&(nt)->lookup_cache[(index) & (NT_LOOKUP_CACHE_SIZE - 1)])
+
+/* Invalidate the entire cache. */
+void names_lookup_cache_clear(name_table * nt);
+
+/* Invalidate the entry for one name. */
+#define names_lookup_cache_forget(nt, index)\
+  BEGIN\
+    uint index_ = (index);\
+    name_lookup_cache_t *pce_ = names_lookup_cache_entry(nt, index_);\
+\
+    if (pce_->nidx == index_)\
+        pce_->nidx = 0;\
+  END
+
 /* ------ Garbage collection ------ */
 
 /* Unmark all non-permanent names before a garbage collection. */
@@ -62,8 +62,7 @@
 
 /*
  * Define the structure for a name string.  The next_index "pointer" is used
- * both for the chained hash table in the name_table and for the list of
- * free names.
+ * for the list of free names.
  */
 typedef struct name_string_s {
 #  define name_extension_bits EXTEND_NAMES
@@ -85,7 +84,18 @@ typedef struct name_string_sub_table_s {
     name_string_t strings[NT_SUB_SIZE];
 } name_string_sub_table_t;
 
-/* Define the size of the name hash table. */
+/*
+ * Define a slot of the name hash index.  The index uses open addressing
+ * with linear probing; each slot keeps the full hash of the name string
+ * beside the name index, so that a probe only has to look at the string
+ * itself when the hashes match.  nidx == 0 marks an empty slot.
+ */
+typedef struct name_hash_slot_s {
+    uint hash;
+    uint nidx;
+} name_hash_slot_t;
+
+/* Define the initial size of the name hash index. */
 #define NT_HASH_SIZE (1024 << (EXTEND_NAMES / 2))  /* must be a power of 2 */
 
 #endif /* inamestr_INCLUDED */
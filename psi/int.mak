@@ -1193,12 +1193,12 @@ $(PSD)jbig2.dev : $(INT_MAK) $(ECHOGS_XE) $(fjbig2_) $(GLD)sjbig2.dev
 	$(ADDMOD) $(PSD)jbig2 -oper zfjbig2
 
 $(PSOBJ)zfjbig2_jbig2dec.$(OBJ) : $(PSSRC)zfjbig2.c $(OP) $(memory__h)\
- $(gsstruct_h) $(gstypes_h) $(ialloc_h) $(idict_h) $(ifilter_h)\
+ $(gsstruct_h) $(gstypes_h) $(ialloc_h) $(idict_h) $(idparam_h) $(ifilter_h)\
  $(store_h) $(stream_h) $(strimpl_h) $(sjbig2_h)
 	$(PSJBIG2CC) $(PSO_)zfjbig2_jbig2dec.$(OBJ) $(C_) $(PSSRC)zfjbig2.c
 
 $(PSOBJ)zfjbig2_luratech.$(OBJ) : $(PSSRC)zfjbig2.c $(OP) $(memory__h)\
- $(gsstruct_h) $(gstypes_h) $(ialloc_h) $(idict_h) $(ifilter_h)\
+ $(gsstruct_h) $(gstypes_h) $(ialloc_h) $(idict_h) $(idparam_h) $(ifilter_h)\
  $(store_h) $(stream_h) $(strimpl_h) $(sjbig2_h)
 	$(PSLDFJB2CC) $(PSO_)zfjbig2_luratech.$(OBJ) $(C_) $(PSSRC)zfjbig2.c
 
@@ -1219,7 +1219,7 @@ $(PSD)jpx_jasper.dev : $(INT_MAK) $(ECHOGS_XE) $(fjpx_jasper) $(GLD)sjpx.dev
 fjpx_luratech=$(PSOBJ)zfjpx_luratech.$(OBJ)
 
 $(PSOBJ)zfjpx.$(OBJ) : $(PSSRC)zfjpx.c $(OP) $(memory__h)\
- $(gsstruct_h) $(gstypes_h) $(ialloc_h) $(idict_h) $(ifilter_h)\
+ $(gsstruct_h) $(gstypes_h) $(ialloc_h) $(idict_h) $(idparam_h) $(ifilter_h)\
  $(store_h) $(stream_h) $(strimpl_h) $(ialloc_h) $(iname_h)\
  $(gdebug_h) $(sjpx_h)
 	$(PSJASCC) $(PSO_)zfjpx.$(OBJ) $(C_) $(PSSRC)zfjpx.c
@@ -1231,7 +1231,7 @@ $(PSD)jpx_luratech.dev : $(INT_MAK) $(ECHOGS_XE) $(fjpx_luratech) $(GLD)sjpx.dev
 	$(ADDMOD) $(PSD)jpx_luratech -oper zfjpx
 
 $(PSOBJ)zfjpx_luratech.$(OBJ) : $(PSSRC)zfjpx.c $(OP) $(memory__h)\
- $(gsstruct_h) $(gstypes_h) $(ialloc_h) $(idict_h) $(ifilter_h)\
+ $(gsstruct_h) $(gstypes_h) $(ialloc_h) $(idict_h) $(idparam_h) $(ifilter_h)\
  $(store_h) $(stream_h) $(strimpl_h) $(sjpx_luratech_h)
 	$(PSLWFJPXCC) $(PSO_)zfjpx_luratech.$(OBJ) \
 		$(C_) $(PSSRC)zfjpx.c
@@ -1245,7 +1245,7 @@ $(PSD)jpx_openjpeg.dev : $(INT_MAK) $(ECHOGS_XE) $(fjpx_openjpeg) $(GLD)sjpx.dev
 	$(ADDMOD) $(PSD)jpx_openjpeg -oper zfjpx
 
 $(PSOBJ)zfjpx_openjpeg.$(OBJ) : $(PSSRC)zfjpx.c $(OP) $(memory__h)\
- $(gsstruct_h) $(gstypes_h) $(ialloc_h) $(idict_h) $(ifilter_h)\
+ $(gsstruct_h) $(gstypes_h) $(ialloc_h) $(idict_h) $(idparam_h) $(ifilter_h)\
  $(store_h) $(stream_h) $(strimpl_h) $(sjpx_openjpeg_h)
 	$(PSOPJJPXCC) $(PSO_)zfjpx_openjpeg.$(OBJ) \
 		$(C_) $(PSSRC)zfjpx.c
@@ -1340,8 +1340,9 @@ $(PSOBJ)zdps1.$(OBJ) : $(PSSRC)zdps1.c $(OP)\
  $(ialloc_h) $(ivmspace_h) $(igstate_h) $(store_h) $(stream_h) $(ibnum_h)
 	$(PSCC) $(PSO_)zdps1.$(OBJ) $(C_) $(PSSRC)zdps1.c
 
-$(PSOBJ)zvmem2.$(OBJ) : $(PSSRC)zvmem2.c $(OP)\
- $(estack_h) $(ialloc_h) $(ivmspace_h) $(store_h) $(ivmem2_h)
+$(PSOBJ)zvmem2.$(OBJ) : $(PSSRC)zvmem2.c $(OP) $(memory__h) $(string__h)\
+ $(estack_h) $(gsstruct_h) $(iastate_h) $(iddict_h) $(isave_h) $(isstate_h)\
+ $(ivmspace_h) $(store_h) $(ivmem2_h)
 	$(PSCC) $(PSO_)zvmem2.$(OBJ) $(C_) $(PSSRC)zvmem2.c
 
 # -------- Composite (PostScript Type 0) font support -------- #
@@ -1981,7 +1982,7 @@ $(PSD)pdfops.dev : $(INT_MAK) $(ECHOGS_XE) $(zpdfops_)
 
 $(PSOBJ)zpdfops.$(OBJ) : $(PSSRC)zpdfops.c $(OP) $(MAKEFILE)\
  $(igstate_h) $(istack_h) $(iutil_h) $(gspath_h) $(math__h) $(ialloc_h)\
- $(string__h) $(store_h)
+ $(string__h) $(store_h) $(files_h) $(stream_h)
 	$(PSCC) $(PSO_)zpdfops.$(OBJ) $(C_) $(PSSRC)zpdfops.c
 
 zutf8_=$(PSOBJ)zutf8.$(OBJ)
@@ -2059,7 +2060,7 @@ $(PSOBJ)interp.$(OBJ) : $(PSSRC)interp.c $(GH) $(memory__h) $(string__h)\
 	$(PSCC) $(PSO_)interp.$(OBJ) $(C_) $(PSSRC)interp.c
 
 $(PSOBJ)ireclaim.$(OBJ) : $(PSSRC)ireclaim.c $(GH)\
- $(gsstruct_h)\
+ $(gp_h) $(gsstruct_h)\
  $(iastate_h) $(icontext_h) $(interp_h) $(isave_h) $(isstate_h)\
  $(dstack_h) $(ierrors_h) $(estack_h) $(opdef_h) $(ostack_h) $(store_h)
 	$(PSCC) $(PSO_)ireclaim.$(OBJ) $(C_) $(PSSRC)ireclaim.c
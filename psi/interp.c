@@ -57,6 +57,20 @@
  */
 #define PACKED_SPECIAL_OPS 1
 
+/*
+ * When the special operators are handled in packed arrays, we can also
+ * look one element ahead and execute some very common pairs at once,
+ * saving a trip through the dispatch switches for the second element.
+ * This never changes the contents of a procedure: the pairs are
+ * recognized when they are executed, and if the fast case doesn't apply
+ * (wrong operand types, stack underflow or overflow), the elements are
+ * simply executed one at a time as usual, so the error behavior is
+ * unchanged.  The pairs recognized are
+ *      exch pop, exch def, pop pop,
+ *      <int> index, <int> add, <int> sub.
+ */
+#define PACKED_SUPERINSTRUCTIONS PACKED_SPECIAL_OPS
+
 /*
  * Pseudo-operators (procedures of type t_oparray) record
  * the operand and dictionary stack pointers, and restore them if an error
@@ -126,6 +140,7 @@ struct stats_interp_s {
     long p_full, p_exec_operator, p_exec_oparray, p_exec_non_x_operator,
         p_integer, p_lit_name, p_exec_name;
     long p_find_name, p_name_lit, p_name_proc;
+    long s_exch_pop, s_exch_def, s_pop_pop, s_int_index, s_int_add;
 } stats_interp;
 # define INCR(v) (++(stats_interp.v))
 #else
@@ -879,6 +894,19 @@ interp(i_ctx_t **pi_ctx_p /* context for execution, updated if resched */,
   if ( --icount <= 0 ) { if ( icount < 0 ) goto up; iesp--; }\
   iref_packed = IREF_NEXT_EITHER(iref_packed); goto top
 
+#if PACKED_SUPERINSTRUCTIONS
+    /* Test whether the next packed element is a given special operator. */
+#  define packed_xop(xop) (pt_tag(pt_executable_operator) + (xop) - (int)tx_op + 1)
+#  define next_is_xop(xop)\
+  (icount > 0 && iref_packed[1] == packed_xop(xop))
+    /*
+     * Consume the first element of a fused pair.  As in next_short,
+     * pop the procedure from the e-stack when only one element remains.
+     */
+#  define skip_short()\
+  BEGIN if ( --icount == 0 ) iesp--; ++iref_packed; END
+#endif
+
 #if !PACKED_SPECIAL_OPS
 #  undef next_either
 #  define next_either() next()
@@ -1151,7 +1179,13 @@ x_sub:      INCR(x_sub);
             goto slice;
         case plain_exec(t_operator):
             INCR(exec_operator);
-            if (--ticks_left <= 0) {    /* The following doesn't work, */
+            /*
+             * Don't let operators count ticks_left below zero: only
+             * procedure calls check it, and a long run of operators
+             * could otherwise reach -100, which slice: takes as a
+             * request to garbage collect.
+             */
+            if (ticks_left > 0 && --ticks_left == 0) {    /* The following doesn't work, */
                 /* and I can't figure out why. */
 /****** goto sst; ******/
             }
@@ -1278,7 +1312,7 @@ remap:              if (iesp + 2 >= estop) {
                     INCR(name_operator);
                     {           /* Shortcut for operators. */
                         /* See above for the logic. */
-                        if (--ticks_left <= 0) {        /* The following doesn't work, */
+                        if (ticks_left > 0 && --ticks_left == 0) {        /* The following doesn't work, */
                             /* and I can't figure out why. */
 /****** goto sst; ******/
                         }
@@ -1496,7 +1530,7 @@ remap:              if (iesp + 2 >= estop) {
                         next();
                     case pt_executable_operator:
                         index = *iref_packed & packed_value_mask;
-                        if (--ticks_left <= 0) {        /* The following doesn't work, */
+                        if (ticks_left > 0 && --ticks_left == 0) {        /* The following doesn't work, */
                             /* and I can't figure out why. */
 /****** goto sst_short; ******/
                         }
@@ -1531,11 +1565,40 @@ remap:              if (iesp + 2 >= estop) {
                               case_xop(tx_op_add):goto x_add;
                               case_xop(tx_op_def):goto x_def;
                               case_xop(tx_op_dup):goto x_dup;
-                              case_xop(tx_op_exch):goto x_exch;
+                              case_xop(tx_op_exch):
+#if PACKED_SUPERINSTRUCTIONS
+                                if (iosp > osbot) {
+                                    if (next_is_xop(tx_op_pop)) {
+                                        INCR(s_exch_pop);
+                                        ref_assign_inline(iosp - 1, iosp);
+                                        iosp--;
+                                        skip_short();
+                                        next_short();
+                                    }
+                                    if (next_is_xop(tx_op_def)) {
+                                        INCR(s_exch_def);
+                                        ref_assign_inline(&token, iosp);
+                                        ref_assign_inline(iosp, iosp - 1);
+                                        ref_assign_inline(iosp - 1, &token);
+                                        skip_short();
+                                        goto x_def;
+                                    }
+                                }
+#endif
+                                goto x_exch;
                               case_xop(tx_op_if):goto x_if;
                               case_xop(tx_op_ifelse):goto x_ifelse;
                               case_xop(tx_op_index):goto x_index;
-                              case_xop(tx_op_pop):goto x_pop;
+                              case_xop(tx_op_pop):
+#if PACKED_SUPERINSTRUCTIONS
+                                if (iosp > osbot && next_is_xop(tx_op_pop)) {
+                                    INCR(s_pop_pop);
+                                    iosp -= 2;
+                                    skip_short();
+                                    next_short();
+                                }
+#endif
+                                goto x_pop;
                               case_xop(tx_op_roll):goto x_roll;
                               case_xop(tx_op_sub):goto x_sub;
                             case 0:     /* for dumb compilers */
@@ -1574,6 +1637,50 @@ remap:              if (iesp + 2 >= estop) {
                         return_with_code_iref();
                     case pt_integer:
                         INCR(p_integer);
+#if PACKED_SUPERINSTRUCTIONS
+                        if (icount > 0 &&
+                            (iref_packed[1] >> r_packed_type_shift) ==
+                              pt_executable_operator
+                            ) {
+                            int ival = ((int)*iref_packed & packed_int_mask) +
+                                packed_min_intval;
+
+                            switch (iref_packed[1]) {
+                                case packed_xop(tx_op_index):
+                                    if (ival >= 0 && iosp - ival >= osbot &&
+                                        iosp < ostop
+                                        ) {
+                                        INCR(s_int_index);
+                                        ++iosp;
+                                        ref_assign_inline(iosp, iosp - 1 - ival);
+                                        skip_short();
+                                        next_short();
+                                    }
+                                    break;
+                                case packed_xop(tx_op_sub):
+                                    ival = -ival;
+                                    /* falls through */
+                                case packed_xop(tx_op_add):
+                                    if (iosp >= osbot &&
+                                        r_has_type(iosp, t_integer)
+                                        ) {
+                                        int sum = iosp->value.intval + ival;
+
+                                        /* On overflow, let zop_add/sub */
+                                        /* convert the result to a real. */
+                                        if ((sum ^ ival) >= 0 ||
+                                            (iosp->value.intval ^ ival) < 0
+                                            ) {
+                                            INCR(s_int_add);
+                                            iosp->value.intval = sum;
+                                            skip_short();
+                                            next_short();
+                                        }
+                                    }
+                                    break;
+                            }
+                        }
+#endif
                         if (iosp >= ostop)
                             return_with_stackoverflow_iref();
                         ++iosp;
@@ -17,6 +17,7 @@
 /* Interpreter's interface to garbage collector */
 #include "ghost.h"
 #include "ierrors.h"
+#include "gp.h"			/* for gp_get_realtime */
 #include "gsstruct.h"
 #include "iastate.h"
 #include "icontext.h"
@@ -96,6 +97,23 @@ ireclaim(gs_dual_memory_t * dmem, int space)
     return 0;
 }
 
+/* Add up the VM allocated and in use, for the GC statistics. */
+static void
+vm_status_total(gs_ref_memory_t **memories, int nmem,
+                gs_memory_status_t *pstat)
+{
+    int i;
+
+    pstat->allocated = pstat->used = 0;
+    for (i = 0; i < nmem; ++i) {
+        gs_memory_status_t status;
+
+        gs_memory_status((gs_memory_t *)memories[i], &status);
+        pstat->allocated += status.allocated;
+        pstat->used += status.used;
+    }
+}
+
 /* Interpreter entry to garbage collector. */
 static void
 gs_vmreclaim(gs_dual_memory_t *dmem, bool global)
@@ -108,7 +126,10 @@ gs_vmreclaim(gs_dual_memory_t *dmem, bool global)
     gs_ref_memory_t *memories[5];
     gs_ref_memory_t *mem;
     int nmem, i;
+    gs_memory_status_t before, after;
+    long start[2], end[2];
 
+    gp_get_realtime(start);
     memories[0] = dmem->space_system;
     memories[1] = mem = dmem->space_global;
     nmem = 2;
@@ -120,6 +141,8 @@ gs_vmreclaim(gs_dual_memory_t *dmem, bool global)
             memories[nmem++] = (gs_ref_memory_t *)mem->stable_memory;
     }
 
+    vm_status_total(memories, nmem, &before);
+
     /****** ABORT IF code < 0 ******/
     for (i = nmem; --i >= 0; )
         alloc_close_chunk(memories[i]);
@@ -179,6 +202,30 @@ gs_vmreclaim(gs_dual_memory_t *dmem, bool global)
 
     code = context_state_load(i_ctx_p);
 
+    /* Update the statistics. */
+
+    vm_status_total(memories, nmem, &after);
+    gp_get_realtime(end);
+    {
+        gs_gc_stats_t *pstats = &dmem->gc_stats;
+        ulong usec = (end[0] - start[0]) * 1000000 +
+            (end[1] - start[1]) / 1000;
+
+        pstats->count++;
+        if (global)
+            pstats->global_count++;
+        pstats->last_time = usec;
+        pstats->total_time += usec;
+        if (usec > pstats->max_time)
+            pstats->max_time = usec;
+        pstats->last_freed =
+            (before.used > after.used ? before.used - after.used : 0);
+        pstats->freed += pstats->last_freed;
+        pstats->last_released =
+            (before.allocated > after.allocated ?
+             before.allocated - after.allocated : 0);
+        pstats->released += pstats->last_released;
+    }
 }
 
 /* ------ Initialization procedure ------ */
@@ -479,30 +479,100 @@ scan_bin_num_array_continue(i_ctx_t *i_ctx_p, ref * pref,
     stream *const s = pstate->s_file.value.pfile;
     scan_binary_state *const pbs = &pstate->s_ss.binary;
     uint index = pbs->index;
+    uint size = r_size(&pbs->bin_array);
     ref *np = pbs->bin_array.value.refs + index;
-    uint wanted = encoded_number_bytes(pbs->num_format);
+    int format = pbs->num_format;
+    uint wanted = encoded_number_bytes(format);
 
-    for (; index < r_size(&pbs->bin_array); index++, np++) {
-        int code;
+    while (index < size) {
+        const byte *p = sbufptr(s);
+        uint count = sbufavailable(s) / wanted;
+        uint done;
+        int code = 0;
 
-        if (sbufavailable(s) < wanted) {
+        if (count == 0) {
             pbs->index = index;
             pstate->s_scan_type = scanning_binary;
             return scan_Refill;
         }
-        code = sdecode_number(sbufptr(s), pbs->num_format, np);
-        switch (code) {
-            case t_integer:
-            case t_real:
-                r_set_type(np, code);
-                sbufskip(s, wanted);
+        if (count > size - index)
+            count = size - index;
+        /*
+         * Decode all the elements that are already in the buffer at once.
+         * The common formats (unscaled integers and IEEE reals) are
+         * decoded inline; the others go through sdecode_number.
+         */
+        switch (format & 0x7f) {
+            case num_int32:
+                if (num_is_lsb(format))
+                    for (done = 0; done < count; done++, p += 4, np++) {
+                        r_set_type(np, t_integer);
+                        np->value.intval =
+                            (int)(((uint)p[3] << 24) + ((uint)p[2] << 16) +
+                                  (p[1] << 8) + p[0]);
+                    }
+                else
+                    for (done = 0; done < count; done++, p += 4, np++) {
+                        r_set_type(np, t_integer);
+                        np->value.intval =
+                            (int)(((uint)p[0] << 24) + ((uint)p[1] << 16) +
+                                  (p[2] << 8) + p[3]);
+                    }
                 break;
-            case t_null:
-                scan_bos_error(pstate, "bad number format");
-                return_error(e_syntaxerror);
+            case num_int16:
+                if (num_is_lsb(format))
+                    for (done = 0; done < count; done++, p += 2, np++) {
+                        int v = (p[1] << 8) + p[0];
+
+                        r_set_type(np, t_integer);
+                        np->value.intval = (v & 0x7fff) - (v & 0x8000);
+                    }
+                else
+                    for (done = 0; done < count; done++, p += 2, np++) {
+                        int v = (p[0] << 8) + p[1];
+
+                        r_set_type(np, t_integer);
+                        np->value.intval = (v & 0x7fff) - (v & 0x8000);
+                    }
+                break;
+#if ARCH_FLOATS_ARE_IEEE
+            case num_float_IEEE:
+                for (done = 0; done < count; done++, p += 4, np++) {
+                    bits32 lnum = (num_is_lsb(format) ?
+                        ((bits32)p[3] << 24) + ((bits32)p[2] << 16) +
+                        (p[1] << 8) + p[0] :
+                        ((bits32)p[0] << 24) + ((bits32)p[1] << 16) +
+                        (p[2] << 8) + p[3]);
+
+                    if (!(~lnum & 0x7f800000)) {	/* Inf or NaN */
+                        code = gs_note_error(e_undefinedresult);
+                        break;
+                    }
+                    r_set_type(np, t_real);
+                    memcpy(&np->value.realval, &lnum, sizeof(float));
+                }
+                break;
+#endif
             default:
-                return code;
+                for (done = 0; done < count; done++, p += wanted, np++) {
+                    code = sdecode_number(p, format, np);
+                    if (code == t_integer || code == t_real)
+                        r_set_type(np, code);
+                    else {
+                        if (code == t_null) {
+                            scan_bos_error(pstate, "bad number format");
+                            code = gs_note_error(e_syntaxerror);
+                        }
+                        break;
+                    }
+                }
+                if (code > 0)
+                    code = 0;
         }
+        sbufskip(s, done * wanted);
+        index += done;
+        if (code < 0)
+            return code;
     }
     *pref = pbs->bin_array;
     return 0;
@@ -529,6 +599,7 @@ scan_bos_continue(i_ctx_t *i_ctx_p, ref * pref, scanner_state * pstate)
     uint index = pbs->index;
     uint size = pbs->size;
     ref *abase = pbs->bin_array.value.refs;
+    uint ready = 0;		/* # of whole objects known to be buffered */
     int code;
 
     pbs->cont = scan_bos_continue;  /* in case of premature return */
@@ -539,13 +610,18 @@ scan_bos_continue(i_ctx_t *i_ctx_p, ref * pref, scanner_state * pstate)
         int value, atype, attrs;
 
         s_end_inline(s, p, rlimit);	/* in case of error */
-        if (rlimit - p < SIZEOF_BIN_SEQ_OBJ) {
-            pbs->index = index;
-            pbs->max_array_index = max_array_index;
-            pbs->min_string_index = min_string_index;
-            pstate->s_scan_type = scanning_binary;
-            return scan_Refill;
+        if (ready == 0) {
+            /* Only check the buffer once for each batch of objects. */
+            ready = (rlimit - p) / SIZEOF_BIN_SEQ_OBJ;
+            if (ready == 0) {
+                pbs->index = index;
+                pbs->max_array_index = max_array_index;
+                pbs->min_string_index = min_string_index;
+                pstate->s_scan_type = scanning_binary;
+                return scan_Refill;
+            }
         }
+        ready--;
         if (p[2] != 0) { /* reserved, must be 0 */
             scan_bos_error(pstate, "non-zero unused field");
             return_error(e_syntaxerror);
@@ -32,8 +32,10 @@ MISC_INIT_FILES=FCOfontmap-PCLPS2 -C cidfmap \
 RESOURCE_LIST=CIDFSubst$(D)* CIDFont$(D)* -C $(PDF_RESOURCE_LIST) ColorSpace$(D)* Decoding$(D)* Encoding$(D)* -B -b Font$(D)* -c -C IdiomSet$(D)* ProcSet$(D)* -P $(PSRESDIR)$(D)Init$(D) -d Resource/Init/ -B $(MISC_INIT_FILES)
 
 #	Notes: gs_cet.ps is only needed to match Adobe CPSI defaults
-PS_ROMFS_ARGS=-c \
-  -d Resource/Init/ -P $(PSRESDIR)$(D)Init$(D) -g gs_init.ps $(gconfig_h) \
+#	The combined gs_init.ps is read in full at every startup, so it is
+#	stored uncompressed (see mkromfs.c); everything else is compressed.
+PS_ROMFS_ARGS=-b \
+  -d Resource/Init/ -P $(PSRESDIR)$(D)Init$(D) -g gs_init.ps $(gconfig_h) -c \
   -d Resource/ -P $(PSRESDIR)$(D) $(RESOURCE_LIST) \
   -d lib/ -P $(PSLIBDIR)$(D) $(EXTRA_INIT_FILES)
 
@@ -71,7 +71,7 @@ zbegin(i_ctx_t *i_ctx_p)
     }
     ++dsp;
     ref_assign(dsp, op);
-    dict_set_top();
+    dict_set_top_begin();
     pop(1);
     return 0;
 }
@@ -114,7 +114,8 @@ zCFD(i_ctx_t *i_ctx_p)
 
 int
 filter_read_predictor(i_ctx_t *i_ctx_p, int npop,
-                      const stream_template * templat, stream_state * st)
+                      const stream_template * templat, stream_state * st,
+                      uint bsize)
 {
     os_ptr op = osp;
     int predictor, code;
@@ -149,7 +150,7 @@ filter_read_predictor(i_ctx_t *i_ctx_p, int npop,
     } else
         predictor = 1;
     if (predictor == 1)
-        return filter_read(i_ctx_p, npop, templat, st, 0);
+        return filter_read_sized(i_ctx_p, npop, templat, st, 0, bsize);
     {
         /* We need to cascade filters. */
         ref rsource, rdict;
@@ -158,7 +159,7 @@ filter_read_predictor(i_ctx_t *i_ctx_p, int npop,
         /* Save the operands, just in case. */
         ref_assign(&rsource, op - 1);
         ref_assign(&rdict, op);
-        code = filter_read(i_ctx_p, 1, templat, st, 0);
+        code = filter_read_sized(i_ctx_p, 1, templat, st, 0, bsize);
         if (code < 0)
             return code;
         /* filter_read changed osp.... */
@@ -240,7 +241,7 @@ zLZWD(i_ctx_t *i_ctx_p)
             lzs.InitialCodeLength = unit_size + 1;
     }
     return filter_read_predictor(i_ctx_p, 0, &s_LZWD_template,
-                                 (stream_state *) & lzs);
+                                 (stream_state *) & lzs, 0);
 }
 
 /* ------ Color differencing filters ------ */
@@ -179,6 +179,14 @@ static int filter_ensure_buf(stream **, uint, gs_ref_memory_t *, bool, int );
 int
 filter_read(i_ctx_t *i_ctx_p, int npop, const stream_template * templat,
             stream_state * st, uint space)
+{
+    return filter_read_sized(i_ctx_p, npop, templat, st, space, 0);
+}
+
+/* Set up an input filter with a buffer of at least bsize bytes. */
+int
+filter_read_sized(i_ctx_t *i_ctx_p, int npop, const stream_template * templat,
+                  stream_state * st, uint space, uint bsize)
 {
     os_ptr op = osp;
     uint min_size = templat->min_out_size + max_min_left;
@@ -237,6 +245,8 @@ filter_read(i_ctx_t *i_ctx_p, int npop, const stream_template * templat,
     }
     if (min_size < 128)
         min_size = file_default_buffer_size;
+    if (min_size < bsize)
+        min_size = bsize;
     code = filter_open("r", min_size, (ref *) sop,
                        &s_filter_read_procs, templat, st, imemory);
     if (code < 0)
@@ -26,6 +26,7 @@
 #include "gstypes.h"
 #include "ialloc.h"
 #include "idict.h"
+#include "idparam.h"
 #include "store.h"
 #include "stream.h"
 #include "strimpl.h"
@@ -67,6 +68,22 @@ z_jpx_decode(i_ctx_t * i_ctx_p)
             if (sop->value.boolval)
                 state.alpha = true;
         }
+#if defined(USE_OPENJPEG_JP2)
+        /* Hints from the PDF interpreter about how much of the image */
+        /* can show on the device, and how many threads to decode in. */
+        {
+            static const float no_region[4] = { 0, 0, 0, 0 };
+            int code;
+
+            if ((code = dict_int_param(op, "Reduce", 0, 32, 0,
+                                       &state.reduce)) < 0 ||
+                (code = dict_int_param(op, "Threads", 1, 256, 1,
+                                       &state.threads)) < 0 ||
+                (code = dict_floats_param(imemory, op, "Region", 4,
+                                          state.region, no_region)) < 0)
+                return code;
+        }
+#endif
         if ( dict_find_string(op, "ColorSpace", &sop) > 0) {
             /* parse the value */
             if (r_is_array(sop)) {
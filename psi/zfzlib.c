@@ -27,6 +27,14 @@
 #include "ifrpred.h"
 #include "ifwpred.h"
 
+/*
+ * Decoding filters get a larger buffer than the default.  zlib decodes
+ * all but the last 258 bytes of each buffer with its fast inner loop, and
+ * much of its time otherwise goes into the calls themselves, so small
+ * buffers cost a good part of the decoding speed.
+ */
+#define ZLIBD_BUFFER_SIZE 16384
+
 /* Common setup for zlib (Flate) filter */
 static int
 filter_zlib(i_ctx_t *i_ctx_p, stream_zlib_state *pzls)
@@ -61,7 +69,8 @@ zzlibD(i_ctx_t *i_ctx_p)
     stream_zlib_state zls;
 
     (*s_zlibD_template.set_defaults)((stream_state *)&zls);
-    return filter_read(i_ctx_p, 0, &s_zlibD_template, (stream_state *)&zls, 0);
+    return filter_read_sized(i_ctx_p, 0, &s_zlibD_template,
+                             (stream_state *)&zls, 0, ZLIBD_BUFFER_SIZE);
 }
 
 /* <source> FlateEncode/filter <file> */
@@ -87,7 +96,7 @@ zFlateD(i_ctx_t *i_ctx_p)
 
     (*s_zlibD_template.set_defaults)((stream_state *)&zls);
     return filter_read_predictor(i_ctx_p, 0, &s_zlibD_template,
-                                 (stream_state *)&zls);
+                                 (stream_state *)&zls, ZLIBD_BUFFER_SIZE);
 }
 
 /* ------ Initialization procedure ------ */
@@ -27,6 +27,8 @@
 #include "malloc_.h"
 #include "string_.h"
 #include "store.h"
+#include "files.h"
+#include "stream.h"
 
 #ifdef HAVE_LIBIDN
 #  include <stringprep.h>
@@ -127,6 +129,240 @@ zpdfinkpath(i_ctx_t *i_ctx_p)
     return 0;
 }
 
+/* ------ Cross-reference tables ------ */
+
+/*
+ * The PDF interpreter keeps its object tables (Objects, ObjectStream and
+ * Generations) in 'lseq's: arrays of subarrays (or substrings) of
+ * 1 << PDF_LSHIFT elements each.  This must agree with lshift in
+ * pdf_base.ps.
+ */
+#define PDF_LSHIFT 9
+
+/* Get the subarray or substring holding element N of an lseq. */
+static int
+pdf_lseq_sub(const ref *plseq, uint n, ref **ppsub, uint *pindex)
+{
+    ref *psub;
+
+    check_read_type(*plseq, t_array);
+    if ((n >> PDF_LSHIFT) >= r_size(plseq))
+        return_error(e_rangecheck);
+    psub = plseq->value.refs + (n >> PDF_LSHIFT);
+    if (!r_has_type(psub, t_array) && !r_has_type(psub, t_string))
+        return_error(e_typecheck);
+    check_write(*psub);
+    *pindex = n & ((1 << PDF_LSHIFT) - 1);
+    if (*pindex >= r_size(psub))
+        return_error(e_rangecheck);
+    *ppsub = psub;
+    return 0;
+}
+
+/*
+ * Enter an xref entry, as setxrefentry in pdf_rbld.ps does when not
+ * rebuilding: an entry is only stored if the object doesn't have one yet.
+ * Return 1 if the entry needs the PostScript code (a generation number
+ * that doesn't fit in Generations), 0 if it was handled, or an error.
+ */
+static int
+pdf_set_xref_entry(i_ctx_t *i_ctx_p, const ref *pobjects,
+                   const ref *pstreams, const ref *pgens,
+                   uint objnum, uint strmnum, uint loc, uint gen)
+{
+    ref *pobjs, *pstrms, *pgs;
+    uint io, is, ig;
+    ref value;
+    int code;
+
+    if ((code = pdf_lseq_sub(pobjects, objnum, &pobjs, &io)) < 0 ||
+        (code = pdf_lseq_sub(pstreams, objnum, &pstrms, &is)) < 0 ||
+        (code = pdf_lseq_sub(pgens, objnum, &pgs, &ig)) < 0
+        )
+        return code;
+    if (!r_has_type(pobjs, t_array) || !r_has_type(pstrms, t_array))
+        return_error(e_typecheck);
+    if (gen >= (r_has_type(pgs, t_string) ? 255 : 65536))
+        return 1;
+    if (!r_has_type(pobjs->value.refs + io, t_null))
+        return 0;
+    make_int(&value, strmnum);
+    r_set_attrs(&value, a_executable);
+    ref_assign_old(pstrms, pstrms->value.refs + is, &value, "pdf_set_xref_entry");
+    make_int(&value, loc);
+    r_set_attrs(&value, a_executable);
+    ref_assign_old(pobjs, pobjs->value.refs + io, &value, "pdf_set_xref_entry");
+    /* Generations holds the generation number + 1; 0 means free. */
+    if (r_has_type(pgs, t_string))
+        pgs->value.bytes[ig] = (byte)(gen + 1);
+    else {
+        make_int(&value, gen + 1);
+        ref_assign_old(pgs, pgs->value.refs + ig, &value, "pdf_set_xref_entry");
+    }
+    return 0;
+}
+
+/*
+ * Make sure that the next LEN bytes of a stream are in its buffer.
+ * Return false at EOF or on an error: the caller leaves those cases
+ * to the PostScript code, which reports them.
+ */
+static bool
+pdf_peek_bytes(stream *s, uint len)
+{
+    while (sbufavailable(s) < len) {
+        if (s->end_status != 0 || len >= s->bsize)
+            return false;
+        s_process_read_buf(s);
+    }
+    return true;
+}
+
+/*
+ * Parse N decimal digits.  Return -1 if they aren't all digits, or if
+ * the value doesn't fit in a long (10 digits may not fit in 32 bits).
+ */
+static long
+pdf_xref_digits(const byte *p, int n)
+{
+    long value = 0;
+
+    for (; n > 0; ++p, --n) {
+        if (*p < '0' || *p > '9' || value > (max_long - 9) / 10)
+            return -1;
+        value = value * 10 + *p - '0';
+    }
+    return value;
+}
+
+/*
+ * Read entries of a classic xref subsection directly into the object
+ * tables.  Only well-formed 20-byte entries are read: at the first one
+ * that isn't (or that needs a warning), we stop before it, so that the
+ * PostScript code can deal with it and call us again for the rest.
+ * <file> <objnum> <count> <Objects> <ObjectStream> <Generations>
+ *   .pdfxrefentries <objnum'> <count'>
+ */
+static int
+zpdfxrefentries(i_ctx_t *i_ctx_p)
+{
+    os_ptr op = osp;
+    stream *s;
+    uint objnum, count;
+    int code = 0;
+
+    check_read_file(i_ctx_p, s, op - 5);
+    check_type(op[-4], t_integer);
+    check_type(op[-3], t_integer);
+    if (op[-4].value.intval < 0 || op[-3].value.intval < 0)
+        return_error(e_rangecheck);
+    objnum = op[-4].value.intval;
+    count = op[-3].value.intval;
+    for (; count > 0; ++objnum, --count) {
+        const byte *p;
+        long loc, gen;
+
+        if (!pdf_peek_bytes(s, 20))
+            break;
+        p = sbufptr(s);
+        loc = pdf_xref_digits(p, 10);
+        gen = pdf_xref_digits(p + 11, 5);
+        if (loc < 0 || loc > max_int || gen < 0 || p[10] != ' ' ||
+            p[16] != ' ' || (p[17] != 'n' && p[17] != 'f') ||
+            (p[18] != ' ' && p[18] != '\r' && p[18] != '\n') ||
+            (p[19] != ' ' && p[19] != '\r' && p[19] != '\n')
+            )
+            break;
+        if (p[17] == 'n') {
+            if (loc == 0)	/* warning case, see readorigxref */
+                break;
+            code = pdf_set_xref_entry(i_ctx_p, op - 2, op - 1, op,
+                                      objnum, 0, (uint)loc, (uint)gen);
+            if (code != 0)
+                break;
+        }
+        s->srptr += 20;
+    }
+    if (code < 0)
+        return code;
+    make_int(op - 5, objnum);
+    make_int(op - 4, count);
+    pop(4);
+    return 0;
+}
+
+/*
+ * Read entries of an xref stream directly into the object tables.
+ * As for .pdfxrefentries, we stop before any entry that the PostScript
+ * code has to handle (an unknown type, a field of more than 4 bytes, or
+ * a premature end of the stream).
+ * <stream> <objnum> <count> <W> <Objects> <ObjectStream> <Generations>
+ *   .pdfxrefstreamentries <objnum'> <count'>
+ */
+static int
+zpdfxrefstreamentries(i_ctx_t *i_ctx_p)
+{
+    os_ptr op = osp;
+    stream *s;
+    uint objnum, count;
+    int w[3], len = 0, i;
+    int code = 0;
+
+    check_read_file(i_ctx_p, s, op - 6);
+    check_type(op[-5], t_integer);
+    check_type(op[-4], t_integer);
+    check_read_type(op[-3], t_array);
+    if (op[-5].value.intval < 0 || op[-4].value.intval < 0)
+        return_error(e_rangecheck);
+    objnum = op[-5].value.intval;
+    count = op[-4].value.intval;
+    if (r_size(op - 3) != 3)
+        count = 0;		/* let the PostScript code complain */
+    for (i = 0; i < 3 && count > 0; ++i) {
+        const ref *pw = op[-3].value.refs + i;
+
+        if (!r_has_type(pw, t_integer) || pw->value.intval < 0 ||
+            pw->value.intval > 4
+            )
+            count = 0;
+        else
+            len += w[i] = pw->value.intval;
+    }
+    for (; count > 0; ++objnum, --count) {
+        const byte *p;
+        ulong field[3];
+        int j;
+
+        if (!pdf_peek_bytes(s, len))
+            break;
+        p = sbufptr(s);
+        for (i = 0; i < 3; ++i) {
+            field[i] = 0;
+            for (j = 0; j < w[i]; ++j)
+                field[i] = (field[i] << 8) + *p++;
+        }
+        if (w[0] == 0)
+            field[0] = 1;	/* default type */
+        if (field[0] > 2 || field[1] > max_int || field[2] > max_int)
+            break;
+        if (field[0] == 1)	/* field 2 = location, field 3 = generation */
+            code = pdf_set_xref_entry(i_ctx_p, op - 2, op - 1, op, objnum,
+                                      0, (uint)field[1], (uint)field[2]);
+        else if (field[0] == 2) /* field 2 = stream number, 3 = index */
+            code = pdf_set_xref_entry(i_ctx_p, op - 2, op - 1, op, objnum,
+                                      (uint)field[1], (uint)field[2], 0);
+        if (code != 0)
+            break;
+        s->srptr += len;
+    }
+    if (code < 0)
+        return code;
+    make_int(op - 6, objnum);
+    make_int(op - 5, count);
+    pop(5);
+    return 0;
+}
+
 #ifdef HAVE_LIBIDN
 /* Given a UTF-8 password string, convert it to the canonical form
  * defined by SASLprep (RFC 4013).  This is a permissive implementation,
@@ -198,6 +434,8 @@ zsaslprep(i_ctx_t *i_ctx_p)
 const op_def zpdfops_op_defs[] =
 {
     {"0.pdfinkpath", zpdfinkpath},
+    {"6.pdfxrefentries", zpdfxrefentries},
+    {"7.pdfxrefstreamentries", zpdfxrefstreamentries},
 #ifdef HAVE_LIBIDN
     {"1.saslprep", zsaslprep},
 #endif
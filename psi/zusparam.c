@@ -408,6 +408,22 @@ current_VMThreshold(i_ctx_t *i_ctx_p)
     gs_memory_gc_status(iimemory_local, &stat);
     return stat.vm_threshold;
 }
+/* Garbage collection statistics (read-only), see gs_vmreclaim. */
+static long
+current_GCCount(i_ctx_t *i_ctx_p)
+{
+    return (long)min(idmemory->gc_stats.count, (ulong)max_long);
+}
+static long
+current_GCLastTime(i_ctx_t *i_ctx_p)
+{
+    return (long)min(idmemory->gc_stats.last_time, (ulong)max_long);
+}
+static long
+current_GCTotalTime(i_ctx_t *i_ctx_p)
+{
+    return (long)min(idmemory->gc_stats.total_time, (ulong)max_long);
+}
 static long
 current_WaitTimeout(i_ctx_t *i_ctx_p)
 {
@@ -570,6 +586,12 @@ static const long_param_def_t user_long_params[] =
      current_VMReclaim, set_vm_reclaim},
     {"VMThreshold", -1, max_long,
      current_VMThreshold, set_vm_threshold},
+    {"GCCount", 0, max_long,
+     current_GCCount, NULL},
+    {"GCLastTime", 0, max_long,
+     current_GCLastTime, NULL},
+    {"GCTotalTime", 0, max_long,
+     current_GCTotalTime, NULL},
     {"WaitTimeout", 0, MAX_UINT_PARAM,
      current_WaitTimeout, set_WaitTimeout},
     /* Extensions */
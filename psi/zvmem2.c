@@ -15,10 +15,17 @@
 
 
 /* Level 2 "Virtual memory" operators */
+#include "memory_.h"
+#include "string_.h"
+#include <stdlib.h>		/* for qsort */
 #include "ghost.h"
 #include "oper.h"
 #include "estack.h"
-#include "ialloc.h"		/* for ivmspace.h */
+#include "gsstruct.h"		/* for struct_type_name_string */
+#include "iastate.h"		/* for ialloc_enum_stats */
+#include "iddict.h"
+#include "isave.h"		/* for isstate.h */
+#include "isstate.h"		/* for mem->saved->state */
 #include "ivmspace.h"
 #include "ivmem2.h"
 #include "store.h"
@@ -123,6 +130,225 @@ zvmreclaim(i_ctx_t *i_ctx_p)
     return_error(e_rangecheck);
 }
 
+/* ------ VM statistics ------ */
+
+/*
+ * The statistics are gathered by walking the chunks when they are asked
+ * for, so the only cost during normal operation is the bookkeeping done
+ * by gs_vmreclaim for each collection.
+ */
+
+#define VMSTATS_MAX_TYPES 1024	/* must be a power of 2 */
+
+typedef struct vmstats_type_s {
+    gs_memory_type_ptr_t pstype;
+    ulong count;
+    ulong bytes;
+} vmstats_type_t;
+
+typedef struct vmstats_s {
+    gs_memory_status_t status;
+    gs_chunk_stats_t chunks;
+    vmstats_type_t *types;	/* hashed by type during the walk, */
+                                /* then merged by name and sorted */
+    int num_types;
+} vmstats_t;
+
+static void
+vmstats_add_object(void *client, gs_memory_type_ptr_t pstype, uint size)
+{
+    vmstats_t *pvs = (vmstats_t *)client;
+    uint i = ((ulong)pstype >> 3) & (VMSTATS_MAX_TYPES - 1);
+    uint n;
+
+    for (n = VMSTATS_MAX_TYPES; n > 0; --n) {
+        vmstats_type_t *pt = &pvs->types[i];
+
+        if (pt->pstype == pstype || pt->pstype == 0) {
+            pt->pstype = pstype;
+            pt->count++;
+            pt->bytes += size;
+            return;
+        }
+        i = (i + 1) & (VMSTATS_MAX_TYPES - 1);
+    }
+    /* The table is full: just drop the object from the breakdown. */
+}
+
+static int
+vmstats_compare_types(const void *p1, const void *p2)
+{
+    const vmstats_type_t *pt1 = (const vmstats_type_t *)p1;
+    const vmstats_type_t *pt2 = (const vmstats_type_t *)p2;
+
+    return (pt1->bytes < pt2->bytes ? 1 : pt1->bytes > pt2->bytes ? -1 : 0);
+}
+
+/* Gather the statistics for all the VM spaces. */
+static int
+vmstats_collect(i_ctx_t *i_ctx_p, vmstats_t *pvs)
+{
+    gs_ref_memory_t *memories[6];
+    gs_ref_memory_t *mem;
+    int nmem = 0, i, j;
+
+    memset(pvs, 0, sizeof(*pvs));
+    pvs->types = (vmstats_type_t *)
+        gs_alloc_byte_array(imemory->non_gc_memory, VMSTATS_MAX_TYPES,
+                            sizeof(vmstats_type_t), "vmstats_collect");
+    if (pvs->types == 0)
+        return_error(e_VMerror);
+    memset(pvs->types, 0, VMSTATS_MAX_TYPES * sizeof(vmstats_type_t));
+    memories[nmem++] = idmemory->space_system;
+    memories[nmem++] = idmemory->space_global;
+    if (idmemory->space_local != idmemory->space_global)
+        memories[nmem++] = idmemory->space_local;
+    for (i = nmem; --i >= 0;)
+        if (memories[i]->stable_memory != (gs_memory_t *)memories[i])
+            memories[nmem++] = (gs_ref_memory_t *)memories[i]->stable_memory;
+    for (i = 0; i < nmem; ++i) {
+        gs_memory_status_t status;
+
+        gs_memory_status((gs_memory_t *)memories[i], &status);
+        pvs->status.allocated += status.allocated;
+        pvs->status.used += status.used;
+        alloc_close_chunk(memories[i]);
+        for (mem = memories[i];; mem = &mem->saved->state) {
+            ialloc_enum_stats(mem, vmstats_add_object, pvs, &pvs->chunks);
+            if (mem->saved == 0)
+                break;
+        }
+    }
+    /* Different types may share a name: report them together. */
+    for (i = 0; i < VMSTATS_MAX_TYPES; ++i) {
+        vmstats_type_t *pt = &pvs->types[i];
+
+        if (pt->pstype == 0)
+            continue;
+        for (j = 0; j < pvs->num_types; ++j)
+            if (!strcmp(struct_type_name_string(pvs->types[j].pstype),
+                        struct_type_name_string(pt->pstype)))
+                break;
+        if (j < pvs->num_types) {
+            pvs->types[j].count += pt->count;
+            pvs->types[j].bytes += pt->bytes;
+        } else
+            pvs->types[pvs->num_types++] = *pt;
+    }
+    qsort(pvs->types, pvs->num_types, sizeof(vmstats_type_t),
+          vmstats_compare_types);
+    return 0;
+}
+
+static void
+vmstats_release(i_ctx_t *i_ctx_p, vmstats_t *pvs)
+{
+    gs_free_object(imemory->non_gc_memory, pvs->types, "vmstats_release");
+}
+
+/* Store a statistic, which may not fit in an integer. */
+static void
+make_vmstat(ref *pref, ulong value)
+{
+    if (value <= max_int)
+        make_int(pref, (int)value);
+    else
+        make_real(pref, (float)value);
+}
+
+/* - .vmstats <dict> */
+static int
+zvmstats(i_ctx_t *i_ctx_p)
+{
+    os_ptr op = osp;
+    const gs_gc_stats_t *pgcs = &idmemory->gc_stats;
+    vmstats_t vs;
+    ref dict, types, entry, value;
+    int code, i;
+    static const char *const names[] = {
+        "GCCount", "GCGlobalCount", "GCTime", "GCMaxPause", "GCLastPause",
+        "GCFreed", "GCReleased", "GCLastFreed", "GCLastReleased",
+        "Allocated", "Used", "Chunks", "FreeGaps", "FreeObjects", "Strings"
+    };
+    ulong values[countof(names)];
+
+    code = vmstats_collect(i_ctx_p, &vs);
+    if (code < 0)
+        return code;
+    values[0] = pgcs->count;
+    values[1] = pgcs->global_count;
+    values[2] = pgcs->total_time;
+    values[3] = pgcs->max_time;
+    values[4] = pgcs->last_time;
+    values[5] = pgcs->freed;
+    values[6] = pgcs->released;
+    values[7] = pgcs->last_freed;
+    values[8] = pgcs->last_released;
+    values[9] = vs.status.allocated;
+    values[10] = vs.status.used;
+    values[11] = vs.chunks.chunks;
+    values[12] = vs.chunks.free_gaps;
+    values[13] = vs.chunks.free_objects;
+    values[14] = vs.chunks.strings;
+    code = dict_create(countof(names) + 1, &dict);
+    for (i = 0; code >= 0 && i < countof(names); ++i) {
+        make_vmstat(&value, values[i]);
+        code = idict_put_string(&dict, names[i], &value);
+    }
+    if (code >= 0)
+        code = dict_create(vs.num_types, &types);
+    for (i = 0; code >= 0 && i < vs.num_types; ++i) {
+        code = ialloc_ref_array(&entry, a_all, 2, ".vmstats");
+        if (code < 0)
+            break;
+        make_vmstat(entry.value.refs, vs.types[i].count);
+        make_vmstat(entry.value.refs + 1, vs.types[i].bytes);
+        code = idict_put_string(&types,
+                        struct_type_name_string(vs.types[i].pstype), &entry);
+    }
+    if (code >= 0)
+        code = idict_put_string(&dict, "Types", &types);
+    vmstats_release(i_ctx_p, &vs);
+    if (code < 0)
+        return code;
+    push(1);
+    ref_assign(op, &dict);
+    return 0;
+}
+
+/* - .printvmstats - */
+/* Write the statistics to stderr as a JSON object. */
+static int
+zprintvmstats(i_ctx_t *i_ctx_p)
+{
+    const gs_gc_stats_t *pgcs = &idmemory->gc_stats;
+    vmstats_t vs;
+    int code = vmstats_collect(i_ctx_p, &vs);
+    int i;
+
+    if (code < 0)
+        return code;
+    errprintf(imemory, "{\"gc\": {\"count\": %lu, \"global_count\": %lu, "
+              "\"time_us\": %lu, \"max_pause_us\": %lu, "
+              "\"last_pause_us\": %lu, \"freed\": %lu, \"released\": %lu},\n",
+              pgcs->count, pgcs->global_count, pgcs->total_time,
+              pgcs->max_time, pgcs->last_time, pgcs->freed, pgcs->released);
+    errprintf(imemory, " \"vm\": {\"allocated\": %lu, \"used\": %lu, "
+              "\"chunks\": %lu, \"free_gaps\": %lu, \"free_objects\": %lu, "
+              "\"strings\": %lu},\n",
+              vs.status.allocated, vs.status.used, vs.chunks.chunks,
+              vs.chunks.free_gaps, vs.chunks.free_objects, vs.chunks.strings);
+    errprintf(imemory, " \"types\": {");
+    for (i = 0; i < vs.num_types; ++i)
+        errprintf(imemory, "%s\n  \"%s\": {\"count\": %lu, \"bytes\": %lu}",
+                  (i == 0 ? "" : ","),
+                  struct_type_name_string(vs.types[i].pstype),
+                  vs.types[i].count, vs.types[i].bytes);
+    errprintf(imemory, "}}\n");
+    vmstats_release(i_ctx_p, &vs);
+    return 0;
+}
+
 /* ------ Initialization procedure ------ */
 
 /* The VM operators are defined even if the initial language level is 1, */
@@ -132,6 +358,8 @@ const op_def zvmem2_op_defs[] =
     {"0.currentglobal", zcurrentglobal},
     {"1.gcheck", zgcheck},
     {"1.setglobal", zsetglobal},
+    {"0.vmstats", zvmstats},
+    {"0.printvmstats", zprintvmstats},
                 /* The rest of the operators are defined only in Level 2. */
     op_def_begin_level2(),
     {"1.vmreclaim", zvmreclaim},
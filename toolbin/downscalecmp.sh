@@ -0,0 +1,120 @@
+#! /bin/sh
+
+# Check and measure the downscaler against a reference build.
+#
+# Usage:
+#	toolbin/downscalecmp.sh [gs] [refgs] [file] [resolution] [pages]
+#
+# Defaults: bin/gs, none, examples/tiger.eps, 150, 3.
+#
+# Render the file with the mono (error diffused), gray and RGB
+# downscaling devices at each DownScaleFactor from 1 to 8, and for the
+# mono device also with MinFeatureSize 2 and 3.  The resolution is that
+# of the output; the page is rendered at the resolution times the factor.
+# With a reference executable (e.g. one built from the previous
+# gxdownscale.c), compare the two outputs byte for byte, ignoring the
+# TIFF time stamp, report any that differ, and exit with a non-zero
+# status if any did.  Each case is rendered the given number of times
+# with each executable and the pages per second are reported.  The
+# devices can be chosen with the MONO, GRAY and RGB environment variables
+# (defaults tiffscaled, pnggray, png16m).
+#
+# With "self" as the reference, $GS must be a DEBUG build: each case is
+# run once with -Z=, which runs the reference versions of the generic
+# cores next to the current ones on every row, and any difference they
+# report is counted.  No second executable is needed.
+
+GS=${1:-bin/gs}
+REFGS=${2:-none}
+FILE=${3:-examples/tiger.eps}
+RES=${4:-150}
+PAGES=${5:-3}
+MONO=${MONO:-tiffscaled}
+GRAY=${GRAY:-pnggray}
+RGB=${RGB:-png16m}
+OUT=${TMPDIR:-/tmp}/downscalecmp.$$
+DIFFS=0
+
+now() {
+    date +%s.%N
+}
+
+# Render $PAGES times with the executable $1 into the file $2, using the
+# device $3 and any further arguments, and print the pages per second.
+run() {
+    gs=$1
+    out=$2
+    device=$3
+    shift 3
+    start=`now`
+    i=0
+    while [ $i -lt $PAGES ]; do
+        $gs -q -dNOPAUSE -dBATCH -dSAFER -sDEVICE=$device -r$RES "$@" \
+            -sOutputFile=$out $FILE || exit 1
+        i=`expr $i + 1`
+    done
+    end=`now`
+    awk -v s=$start -v e=$end -v n=$PAGES 'BEGIN { printf "%.2f", n / (e - s) }'
+}
+
+# Compare two output files, ignoring a TIFF DateTime tag.
+same() {
+    for f in $1 $2; do
+        LC_ALL=C sed -e 's/[0-9]\{4\}:[0-9][0-9]:[0-9][0-9] [0-9][0-9]:[0-9][0-9]:[0-9][0-9]/0000:00:00 00:00:00/' \
+            < $f > $f.masked
+    done
+    cmp -s $1.masked $2.masked
+    status=$?
+    rm -f $1.masked $2.masked
+    return $status
+}
+
+check() {
+    label=$1
+    shift
+    if [ "$REFGS" = self ]; then
+        new=`run $GS $OUT.new "$@" -Z= 2>$OUT.log` || { echo "$label: $GS failed"; exit 1; }
+        if grep -q 'differ.* from the reference' $OUT.log; then
+            result=DIFFERENT
+            DIFFS=`expr $DIFFS + 1`
+        else
+            result=same
+        fi
+        printf "%-28s %8s pages/s  %s\n" "$label" $new $result
+        return
+    fi
+    new=`run $GS $OUT.new "$@"` || { echo "$label: $GS failed"; exit 1; }
+    if [ "$REFGS" = none ]; then
+        printf "%-28s %8s pages/s\n" "$label" $new
+        return
+    fi
+    ref=`run $REFGS $OUT.ref "$@"` || { echo "$label: $REFGS failed"; exit 1; }
+    if same $OUT.ref $OUT.new; then
+        result=same
+    else
+        result=DIFFERENT
+        DIFFS=`expr $DIFFS + 1`
+    fi
+    printf "%-28s %8s %8s pages/s  %s\n" "$label" $ref $new $result
+}
+
+echo "$FILE at $RES dpi:"
+if [ "$REFGS" != none -a "$REFGS" != self ]; then
+    printf "%-28s %8s %8s\n" "" reference new
+fi
+for device in $MONO $GRAY $RGB; do
+    for factor in 1 2 3 4 5 6 7 8; do
+        check "$device, factor $factor" $device -dDownScaleFactor=$factor
+    done
+done
+for mfs in 2 3; do
+    for factor in 1 2 3 4 5 6 7 8; do
+        check "$MONO, factor $factor, mfs $mfs" $MONO \
+            -dDownScaleFactor=$factor -dMinFeatureSize=$mfs
+    done
+done
+rm -f $OUT.ref $OUT.new $OUT.log
+if [ $DIFFS -ne 0 ]; then
+    echo "$DIFFS outputs differ from the reference."
+    exit 1
+fi
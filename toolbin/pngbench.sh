@@ -0,0 +1,52 @@
+#! /bin/sh
+
+# Measure the speed of the PNG devices with various compression settings.
+#
+# Usage:
+#	toolbin/pngbench.sh [gs] [file] [device] [resolution] [pages]
+#
+# Defaults: bin/gs, examples/tiger.eps, png16m, 300, 5.
+#
+# Render the file the given number of times with the default settings,
+# with a fast filter and compression level, and with 1, 2 and 4 threads
+# compressing the image data, and report pages per second and the size
+# of one page of output, so that settings can be compared at equal
+# output size.
+
+GS=${1:-bin/gs}
+FILE=${2:-examples/tiger.eps}
+DEVICE=${3:-png16m}
+RES=${4:-300}
+PAGES=${5:-5}
+OUT=${TMPDIR:-/tmp}/pngbench.$$.png
+
+now() {
+    date +%s.%N
+}
+
+bench() {
+    label=$1
+    shift
+    start=`now`
+    i=0
+    while [ $i -lt $PAGES ]; do
+        $GS -q -dNOPAUSE -dBATCH -dSAFER -sDEVICE=$DEVICE -r$RES "$@" \
+            -sOutputFile=$OUT $FILE || exit 1
+        i=`expr $i + 1`
+    done
+    end=`now`
+    size=`wc -c < $OUT`
+    awk -v l="$label" -v s=$start -v e=$end -v n=$PAGES -v b=$size \
+        'BEGIN { printf "%-28s %8.2f pages/s %10d bytes\n", l, n / (e - s), b }'
+}
+
+echo "$DEVICE, $RES dpi, $FILE:"
+bench "default"
+bench "filter none, level 1" -dPNGFilter=/none -dPNGCompressionLevel=1
+bench "filter up, level 3" -dPNGFilter=/up -dPNGCompressionLevel=3
+bench "default, 1 thread" -dNumRenderingThreads=1
+bench "default, 2 threads" -dNumRenderingThreads=2
+bench "default, 4 threads" -dNumRenderingThreads=4
+bench "filter up, level 3, 4 threads" -dPNGFilter=/up -dPNGCompressionLevel=3 \
+    -dNumRenderingThreads=4
+rm -f $OUT